@@ -0,0 +1,102 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "BKTree.h"
+#include "../IndexedToken/IndexedToken.h"
+#include <algorithm>
+
+// Single-row dynamic programming; the row buffer is reused per thread
+size_t editDistance(std::string_view a, std::string_view b) {
+    if (a.size() < b.size()) std::swap(a, b);  // keep the row over the shorter string
+    if (b.empty()) return a.size();
+
+    static thread_local std::vector<size_t> row;
+    row.resize(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) {
+        row[j] = j;
+    }
+
+    for (size_t i = 1; i <= a.size(); ++i) {
+        size_t diagonal = row[0];  // row[i-1][j-1]
+        row[0] = i;
+        for (size_t j = 1; j <= b.size(); ++j) {
+            size_t above = row[j];  // row[i-1][j]
+            size_t cost = (a[i - 1] == b[j - 1]) ? 0 : 1;
+            row[j] = std::min({above + 1, row[j - 1] + 1, diagonal + cost});
+            diagonal = above;
+        }
+    }
+    return row[b.size()];
+}
+
+// Walk down along exact-distance edges until a free slot is found
+template <typename Value>
+void BKTree<Value>::insert(std::string_view key, Value value) {
+    if (nodes.empty()) {
+        nodes.push_back(Node{key, value, {}});
+        return;
+    }
+
+    size_t current = 0;
+    while (true) {
+        size_t distance = editDistance(key, nodes[current].key);
+        if (distance == 0) return;  // already present
+
+        auto& children = nodes[current].children;
+        auto edge = std::find_if(children.begin(), children.end(),
+                                 [distance](const auto& child) { return child.first == distance; });
+        if (edge == children.end()) {
+            children.emplace_back(distance, nodes.size());
+            nodes.push_back(Node{key, value, {}});  // may reallocate: children not used after this
+            return;
+        }
+        current = edge->second;
+    }
+}
+
+// Depth-first search pruned by the triangle inequality
+template <typename Value>
+std::vector<typename BKTree<Value>::match_type> BKTree<Value>::search(std::string_view query, size_t maxDistance) const {
+    std::vector<match_type> matches;
+    if (nodes.empty()) return matches;
+
+    std::vector<size_t> pending{0};
+    while (!pending.empty()) {
+        const Node& node = nodes[pending.back()];
+        pending.pop_back();
+
+        size_t distance = editDistance(query, node.key);
+        if (distance <= maxDistance) {
+            matches.emplace_back(node.value, distance);
+        }
+
+        size_t low = distance > maxDistance ? distance - maxDistance : 0;
+        size_t high = distance + maxDistance;
+        for (const auto& child : node.children) {
+            if (child.first >= low && child.first <= high) {
+                pending.push_back(child.second);
+            }
+        }
+    }
+    return matches;
+}
+
+template <typename Value>
+size_t BKTree<Value>::size() const {
+    return nodes.size();
+}
+
+template <typename Value>
+bool BKTree<Value>::isEmpty() const {
+    return nodes.empty();
+}
+
+template <typename Value>
+void BKTree<Value>::clear() {
+    nodes.clear();
+}
+
+// Explicit instantiations for the index entry types
+template class BKTree<const IndexedToken*>;
+template class BKTree<const LargeIndexedToken*>;
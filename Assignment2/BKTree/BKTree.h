@@ -0,0 +1,65 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#ifndef BK_TREE_H
+#define BK_TREE_H
+
+#include <cstddef>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Levenshtein (insert / delete / substitute) distance between two strings
+ */
+size_t editDistance(std::string_view a, std::string_view b);
+
+/**
+ * @class BKTree
+ * @brief Burkhard-Keller tree over string keys under edit distance.
+ *
+ * Every child hangs off its parent at their exact distance, so a search for
+ * everything within k of a query only descends into children whose edge
+ * distance lies in [d - k, d + k] (triangle inequality), skipping most of
+ * the dictionary. Keys are views; the strings they refer to must outlive the tree.
+ */
+template <typename Value>
+class BKTree {
+public:
+    // A match and its distance from the query
+    using match_type = std::pair<Value, size_t>;
+
+private:
+    struct Node {
+        std::string_view key;
+        Value value;
+        std::vector<std::pair<size_t, size_t>> children;  // (edge distance, node index)
+    };
+
+    std::vector<Node> nodes;  // nodes[0] is the root
+
+public:
+    BKTree() = default;
+    BKTree(const BKTree& other) = default;
+    BKTree(BKTree&& other) noexcept = default;
+    BKTree& operator=(const BKTree& other) = default;
+    BKTree& operator=(BKTree&& other) noexcept = default;
+    ~BKTree() = default;
+
+    /**
+     * @brief Add a key; duplicate keys are ignored
+     */
+    void insert(std::string_view key, Value value);
+
+    /**
+     * @brief All values whose key is within maxDistance edits of query (unordered)
+     */
+    std::vector<match_type> search(std::string_view query, size_t maxDistance) const;
+
+    size_t size() const;
+    bool isEmpty() const;
+    void clear();
+};
+
+#endif // BK_TREE_H
@@ -0,0 +1,216 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "BatchQueryRunner.h"
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include "../QueryEngine/QueryEngine.h"
+#include "../ThreadPool/ThreadPool.h"
+
+// Constructor
+template <typename Traits>
+BasicBatchQueryRunner<Traits>::BasicBatchQueryRunner(const indexer_type& indexer, size_t threadCount)
+    : indexer(indexer), threadCount(threadCount) {}
+
+// Splits "<kind> <argument>" and validates the argument
+template <typename Traits>
+typename BasicBatchQueryRunner<Traits>::Query BasicBatchQueryRunner<Traits>::parseLine(const std::string& line,
+                                                                                       size_t lineNumber) {
+    std::istringstream words(line);
+    std::string kind;
+    words >> kind;
+    std::string argument;
+    std::getline(words >> std::ws, argument);
+    while (!argument.empty() && std::isspace(static_cast<unsigned char>(argument.back()))) {
+        argument.pop_back();
+    }
+
+    auto fail = [&](const std::string& reason) {
+        if (lineNumber == 0) return std::invalid_argument(reason);  // A single query, not from a file
+        return std::invalid_argument("Query line " + std::to_string(lineNumber) + ": " + reason);
+    };
+    if (argument.empty()) {
+        throw fail("missing argument for '" + kind + "'");
+    }
+
+    Query query;
+    query.text = line;
+    query.argument = argument;
+    if (kind == "token") {
+        query.kind = Query::Kind::Token;
+    } else if (kind == "length") {
+        query.kind = Query::Kind::Length;
+        if (argument.find_first_not_of("0123456789") != std::string::npos) {
+            throw fail("length must be a non-negative integer");
+        }
+        try {
+            query.length = std::stoull(argument);
+        } catch (const std::out_of_range&) {
+            throw fail("length is too large");
+        }
+    } else if (kind == "section") {
+        query.kind = Query::Kind::Section;
+        if (argument.size() != 1 || !(std::isalpha(static_cast<unsigned char>(argument[0])) || argument[0] == '*')) {
+            throw fail("section must be A-Z or *");
+        }
+    } else if (kind == "query") {
+        query.kind = Query::Kind::Boolean;
+    } else {
+        throw fail("unknown query type '" + kind + "' (expected token, length, section or query)");
+    }
+    return query;
+}
+
+template <typename Traits>
+void BasicBatchQueryRunner<Traits>::loadFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open query file: " + filename);
+    }
+
+    std::vector<Query> loaded;
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') continue;
+        loaded.push_back(parseLine(line.substr(first), lineNumber));
+    }
+    queries = std::move(loaded);
+}
+
+template <typename Traits>
+void BasicBatchQueryRunner<Traits>::addQuery(const std::string& line) {
+    queries.push_back(parseLine(line, queries.size() + 1));
+}
+
+template <typename Traits>
+size_t BasicBatchQueryRunner<Traits>::size() const {
+    return queries.size();
+}
+
+template <typename Traits>
+std::string BasicBatchQueryRunner<Traits>::evaluate(const indexer_type& indexer, const std::string& line) {
+    size_t first = line.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        throw std::invalid_argument("Empty query");
+    }
+    return result(indexer, parseLine(line.substr(first), 0));
+}
+
+// Evaluates one query into its own buffer so workers never share a stream
+template <typename Traits>
+std::string BasicBatchQueryRunner<Traits>::render(const Query& query) const {
+    return "> " + query.text + '\n' + result(indexer, query);
+}
+
+template <typename Traits>
+std::string BasicBatchQueryRunner<Traits>::result(const indexer_type& indexer, const Query& query) {
+    std::ostringstream out;
+    try {
+        switch (query.kind) {
+            case Query::Kind::Token: {
+                const auto* entry = indexer.findToken(query.argument);
+                if (entry == nullptr) {
+                    out << "Token '" << query.argument << "' not found.\n";
+                } else {
+                    entry->print(out);
+                    out << '\n';
+                }
+                break;
+            }
+            case Query::Kind::Length:
+                indexer.searchByLength(query.length, out);
+                break;
+            case Query::Kind::Section: {
+                char section = query.argument[0];
+                int sectionIndex = std::isalpha(static_cast<unsigned char>(section))
+                                       ? std::tolower(static_cast<unsigned char>(section)) - 'a'
+                                       : indexer_type::NUM_SECTIONS - 1;
+                indexer.displaySection(sectionIndex, out);
+                break;
+            }
+            case Query::Kind::Boolean: {
+                BasicQueryEngine<Traits> engine(indexer);
+                auto lines = engine.evaluate(query.argument);
+                if (lines.empty()) {
+                    out << "No matching lines.\n";
+                } else {
+                    out << "Matching lines (" << lines.size() << "):";
+                    for (auto it = lines.cbegin(); it != lines.cend(); ++it) {
+                        out << ' ' << *it;
+                    }
+                    out << '\n';
+                }
+                break;
+            }
+        }
+    } catch (const std::exception& e) {
+        out << "Error: " << e.what() << '\n';
+    }
+    return std::move(out).str();
+}
+
+// Workers claim query indices from a shared counter; each result lands in its
+// own slot, so the output order does not depend on scheduling
+template <typename Traits>
+typename BasicBatchQueryRunner<Traits>::Stats BasicBatchQueryRunner<Traits>::run(std::ostream& os) const {
+    using clock = std::chrono::steady_clock;
+
+    Stats stats;
+    stats.queries = queries.size();
+    if (queries.empty()) return stats;
+
+    std::vector<std::string> results(queries.size());
+    std::vector<std::chrono::nanoseconds> latencies(queries.size());
+    std::atomic<size_t> next{0};
+
+    auto start = clock::now();
+    {
+        ThreadPool pool(threadCount);
+        stats.threads = std::min(pool.size(), queries.size());
+        for (size_t worker = 0; worker < stats.threads; ++worker) {
+            pool.enqueue([&] {
+                for (size_t i = next.fetch_add(1); i < queries.size(); i = next.fetch_add(1)) {
+                    auto queryStart = clock::now();
+                    results[i] = render(queries[i]);
+                    latencies[i] = clock::now() - queryStart;
+                }
+            });
+        }
+        pool.waitIdle();
+    }
+    stats.wallTime = clock::now() - start;
+
+    // One large write instead of one per query
+    size_t total = 0;
+    for (auto it = results.cbegin(); it != results.cend(); ++it) total += it->size();
+    std::string output;
+    output.reserve(total);
+    for (auto it = results.cbegin(); it != results.cend(); ++it) output += *it;
+    os.write(output.data(), static_cast<std::streamsize>(output.size()));
+    os.flush();
+
+    // Nearest-rank percentiles
+    auto percentile = [&](size_t pct) {
+        size_t rank = (pct * latencies.size() + 99) / 100;
+        auto nth = latencies.begin() + static_cast<std::ptrdiff_t>(rank == 0 ? 0 : rank - 1);
+        std::nth_element(latencies.begin(), nth, latencies.end());
+        return *nth;
+    };
+    stats.p50 = percentile(50);
+    stats.p99 = percentile(99);
+    double seconds = std::chrono::duration<double>(stats.wallTime).count();
+    stats.queriesPerSecond = seconds > 0.0 ? static_cast<double>(stats.queries) / seconds : 0.0;
+    return stats;
+}
+
+// Explicit instantiations for the supported index widths
+template class BasicBatchQueryRunner<CompactIndexTraits>;
+template class BasicBatchQueryRunner<LargeIndexTraits>;
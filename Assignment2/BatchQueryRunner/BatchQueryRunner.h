@@ -0,0 +1,97 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Runs a file of lookups concurrently against one read-only index
+//
+
+#ifndef BATCH_QUERY_RUNNER_H
+#define BATCH_QUERY_RUNNER_H
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "../Indexer/Indexer.h"
+
+/**
+ * @class BasicBatchQueryRunner
+ * @brief Loads queries from a file, evaluates them on a thread pool and writes
+ * the results in input order.
+ *
+ * One query per line; blank lines and lines starting with '#' are skipped:
+ *   token <word>       the entry for one token
+ *   length <n>         tokens of length n (same output as the menu option)
+ *   section <A-Z|*>    one section (same output as the menu option)
+ *   query <expr>       boolean query (see BasicQueryEngine)
+ * Malformed lines throw std::invalid_argument when the file is loaded;
+ * a query that fails at evaluation reports its error in place of a result.
+ */
+template <typename Traits>
+class BasicBatchQueryRunner {
+public:
+    using indexer_type = BasicIndexer<Traits>;
+
+    // Throughput and latency of the last run
+    struct Stats {
+        size_t queries = 0;
+        size_t threads = 0;
+        std::chrono::nanoseconds wallTime{0};
+        std::chrono::nanoseconds p50{0};
+        std::chrono::nanoseconds p99{0};
+        double queriesPerSecond = 0.0;
+    };
+
+private:
+    struct Query {
+        enum class Kind { Token, Length, Section, Boolean };
+        Kind kind;
+        std::string text;      // The line as written, echoed before the result
+        std::string argument;  // Word, expression or section character
+        size_t length = 0;     // Kind::Length only
+    };
+
+    const indexer_type& indexer;
+    std::vector<Query> queries;
+    size_t threadCount;
+
+    static Query parseLine(const std::string& line, size_t lineNumber);
+    // The result text of a query, without the echoed query line
+    static std::string result(const indexer_type& indexer, const Query& query);
+    std::string render(const Query& query) const;
+
+public:
+    // The index must outlive the runner and must not change while run() executes.
+    // threadCount 0 = one worker per hardware thread.
+    explicit BasicBatchQueryRunner(const indexer_type& indexer, size_t threadCount = 0);
+
+    /**
+     * @brief Read queries from a file, replacing any loaded before
+     */
+    void loadFile(const std::string& filename);
+
+    /**
+     * @brief Add one query line (same syntax as the file)
+     */
+    void addQuery(const std::string& line);
+
+    size_t size() const;
+
+    /**
+     * @brief Result text of one query line (same syntax and output as a loaded query,
+     * without the "> query" echo). Throws std::invalid_argument for a malformed line.
+     */
+    static std::string evaluate(const indexer_type& indexer, const std::string& line);
+
+    /**
+     * @brief Evaluate every loaded query and write "> query" followed by its result, in input order
+     */
+    Stats run(std::ostream& os = std::cout) const;
+};
+
+using BatchQueryRunner = BasicBatchQueryRunner<CompactIndexTraits>;
+using LargeBatchQueryRunner = BasicBatchQueryRunner<LargeIndexTraits>;
+
+extern template class BasicBatchQueryRunner<CompactIndexTraits>;
+extern template class BasicBatchQueryRunner<LargeIndexTraits>;
+
+#endif // BATCH_QUERY_RUNNER_H
@@ -0,0 +1,130 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "BufferedWriter.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+    // "00" "01" ... "99": two digits per division instead of one
+    constexpr char DIGIT_PAIRS[201] =
+        "00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+        "40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+        "8081828384858687888990919293949596979899";
+
+    // Values formatted per block by writeNumbers, bounding how far the buffer grows past capacity
+    constexpr size_t NUMBER_BLOCK = 4096;
+
+} // namespace
+
+char* BufferedWriter::formatUnsigned(char* dst, std::uint64_t value) {
+    char digits[MAX_DIGITS];
+    char* end = digits + MAX_DIGITS;
+    char* first = end;
+    while (value >= 100) {
+        first -= 2;
+        std::memcpy(first, DIGIT_PAIRS + 2 * (value % 100), 2);
+        value /= 100;
+    }
+    if (value >= 10) {
+        first -= 2;
+        std::memcpy(first, DIGIT_PAIRS + 2 * value, 2);
+    } else {
+        *--first = static_cast<char>('0' + value);
+    }
+    size_t count = static_cast<size_t>(end - first);
+    std::memcpy(dst, first, count);
+    return dst + count;
+}
+
+// Stream sink - the buffer is allocated once and reused after every write
+BufferedWriter::BufferedWriter(std::ostream& os, size_t capacity) : stream(&os), capacity(capacity) {
+    buffer.reserve(capacity);
+}
+
+// String sink
+BufferedWriter::BufferedWriter(std::string& target) : target(&target), capacity(0) {}
+
+BufferedWriter::~BufferedWriter() {
+    try {
+        flush();
+    } catch (...) {
+        // Destructors must not throw; a failed stream keeps its error state
+    }
+}
+
+void BufferedWriter::spill() {
+    if (stream && buffer.size() >= capacity) {
+        stream->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+}
+
+void BufferedWriter::write(std::string_view text) {
+    out().append(text);
+    spill();
+}
+
+void BufferedWriter::put(char c) {
+    out().push_back(c);
+    spill();
+}
+
+void BufferedWriter::writeUnsigned(std::uint64_t value) {
+    char digits[MAX_DIGITS];
+    write(std::string_view(digits, static_cast<size_t>(formatUnsigned(digits, value) - digits)));
+}
+
+void BufferedWriter::writeSigned(std::int64_t value) {
+    if (value < 0) {
+        put('-');
+        // Negate in unsigned arithmetic so INT64_MIN does not overflow
+        writeUnsigned(0 - static_cast<std::uint64_t>(value));
+    } else {
+        writeUnsigned(static_cast<std::uint64_t>(value));
+    }
+}
+
+// Sizes the sink for the worst case of each block, formats in place, then trims
+template <typename T>
+void BufferedWriter::writeNumberList(std::span<const T> values, char separator) {
+    for (size_t first = 0; first < values.size(); first += NUMBER_BLOCK) {
+        size_t count = std::min(NUMBER_BLOCK, values.size() - first);
+        std::string& sink = out();
+        size_t start = sink.size();
+        sink.resize(start + count * (MAX_DIGITS + 1));
+        char* cursor = sink.data() + start;
+        for (size_t i = first; i < first + count; ++i) {
+            if (i != 0) *cursor++ = separator;
+            cursor = formatUnsigned(cursor, values[i]);
+        }
+        sink.resize(static_cast<size_t>(cursor - sink.data()));
+        spill();
+    }
+}
+
+void BufferedWriter::writeNumbers(std::span<const std::uint32_t> values, char separator) {
+    writeNumberList(values, separator);
+}
+
+void BufferedWriter::writeNumbers(std::span<const std::uint64_t> values, char separator) {
+    writeNumberList(values, separator);
+}
+
+void BufferedWriter::reserve(size_t n) {
+    std::string& sink = out();
+    if (sink.capacity() - sink.size() < n) {
+        sink.reserve(sink.size() + n);
+    }
+}
+
+void BufferedWriter::flush() {
+    if (!stream) return;
+    if (!buffer.empty()) {
+        stream->write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        buffer.clear();
+    }
+    stream->flush();
+}
@@ -0,0 +1,95 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Bulk output for the print paths
+//
+
+#ifndef BUFFERED_WRITER_H
+#define BUFFERED_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <span>
+#include <string>
+#include <string_view>
+
+/**
+ * @class BufferedWriter
+ * @brief Collects output in one large reusable buffer and hands it to the
+ * sink in big blocks, instead of one flushing write per line.
+ *
+ * The sink is either a stream (written when the buffer fills and on flush())
+ * or a string that is appended to directly. Nothing reaches a stream sink
+ * until a flush point, so callers write '\n' and call flush() once at the
+ * end of an operation where they used std::endl per line before.
+ */
+class BufferedWriter {
+private:
+    std::ostream* stream = nullptr;  // Stream sink
+    std::string* target = nullptr;   // String sink (appended to directly)
+    std::string buffer;              // Pending bytes for the stream sink
+    size_t capacity;
+
+    std::string& out() { return target ? *target : buffer; }
+    void spill();  // Write the buffer to the stream once it is full
+
+    template <typename T>
+    void writeNumberList(std::span<const T> values, char separator);
+
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 1 << 20;  // 1 MiB
+    static constexpr size_t MAX_DIGITS = 20;  // Longest std::uint64_t / std::int64_t text
+
+    /**
+     * @brief Decimal digits of value written at dst (at most MAX_DIGITS bytes), two at a
+     * time from a lookup table; returns one past the last digit
+     */
+    static char* formatUnsigned(char* dst, std::uint64_t value);
+
+    explicit BufferedWriter(std::ostream& os, size_t capacity = DEFAULT_CAPACITY);
+    explicit BufferedWriter(std::string& target);
+
+    // Owns pending output that belongs to one sink
+    BufferedWriter(const BufferedWriter& other) = delete;
+    BufferedWriter& operator=(const BufferedWriter& other) = delete;
+
+    /**
+     * @brief Flushes whatever is still buffered (errors are ignored here; call flush() to see them)
+     */
+    ~BufferedWriter();
+
+    void write(std::string_view text);
+    void put(char c);
+    void writeUnsigned(std::uint64_t value);
+    void writeSigned(std::int64_t value);
+
+    /**
+     * @brief Values separated by separator (no trailing separator), formatted
+     * straight into the buffer in blocks rather than one append per number
+     */
+    void writeNumbers(std::span<const std::uint32_t> values, char separator = ' ');
+    void writeNumbers(std::span<const std::uint64_t> values, char separator = ' ');
+
+    /**
+     * @brief Room for at least n more bytes without a reallocation or write
+     */
+    void reserve(size_t n);
+
+    /**
+     * @brief Hand everything buffered to the stream and flush the stream
+     */
+    void flush();
+
+    BufferedWriter& operator<<(std::string_view text) { write(text); return *this; }
+    BufferedWriter& operator<<(const char* text) { write(text); return *this; }
+    BufferedWriter& operator<<(const std::string& text) { write(text); return *this; }
+    BufferedWriter& operator<<(char c) { put(c); return *this; }
+    BufferedWriter& operator<<(unsigned value) { writeUnsigned(value); return *this; }
+    BufferedWriter& operator<<(unsigned long value) { writeUnsigned(value); return *this; }
+    BufferedWriter& operator<<(unsigned long long value) { writeUnsigned(value); return *this; }
+    BufferedWriter& operator<<(int value) { writeSigned(value); return *this; }
+    BufferedWriter& operator<<(long value) { writeSigned(value); return *this; }
+    BufferedWriter& operator<<(long long value) { writeSigned(value); return *this; }
+};
+
+#endif // BUFFERED_WRITER_H
@@ -0,0 +1,83 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// LEB128 varints and raw fixed-width words, shared by the in-memory and on-disk encodings
+//
+
+#ifndef BYTE_CODING_H
+#define BYTE_CODING_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+// These are called once per posting or length, so they are defined here to inline
+
+// Longest LEB128 encoding of a 64-bit value
+const size_t MAX_VARINT_SIZE = 10;
+
+/**
+ * @brief LEB128-encode value into out (at least MAX_VARINT_SIZE bytes):
+ * seven bits per byte, high bit set on all but the last byte
+ * @return The number of bytes written
+ */
+inline size_t encodeVarint(std::uint64_t value, char* out) {
+    size_t size = 0;
+    while (value >= 0x80) {
+        out[size++] = static_cast<char>((value & 0x7F) | 0x80);
+        value >>= 7;
+    }
+    out[size++] = static_cast<char>(value);
+    return size;
+}
+
+/**
+ * @brief Append value as LEB128 to a byte container (std::string, std::vector<std::uint8_t>)
+ */
+template <typename Bytes>
+void appendVarint(Bytes& out, std::uint64_t value) {
+    char bytes[MAX_VARINT_SIZE];
+    size_t size = encodeVarint(value, bytes);
+    out.insert(out.end(), bytes, bytes + size);
+}
+
+/**
+ * @brief Decode the LEB128 value at data[offset], never reading at or past end.
+ * offset moves past the bytes consumed.
+ * @return false if the value is truncated or longer than MAX_VARINT_SIZE bytes
+ */
+template <typename Byte>
+bool readVarint(const Byte* data, size_t end, size_t& offset, std::uint64_t& value) {
+    static_assert(sizeof(Byte) == 1, "readVarint reads a byte buffer");
+    value = 0;
+    for (unsigned shift = 0; shift < 64 && offset < end; shift += 7) {
+        unsigned char byte = static_cast<unsigned char>(data[offset++]);
+        value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Append the native-endian bytes of value to out
+ */
+template <typename T>
+void appendWord(std::string& out, T value) {
+    char bytes[sizeof(value)];
+    std::memcpy(bytes, &value, sizeof(value));
+    out.append(bytes, sizeof(value));
+}
+
+/**
+ * @brief The native-endian T at data; data need not be aligned
+ */
+template <typename T>
+T readWord(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+#endif // BYTE_CODING_H
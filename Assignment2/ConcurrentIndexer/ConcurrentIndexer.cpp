@@ -0,0 +1,221 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "ConcurrentIndexer.h"
+#include <algorithm>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+// Constructor
+template <typename Traits>
+BasicConcurrentIndexer<Traits>::BasicConcurrentIndexer(size_t stripesPerSection, bool positional,
+                                                       bool caseInsensitive)
+    : stripesPerSection(stripesPerSection), positional(positional), caseInsensitive(caseInsensitive) {
+    if (stripesPerSection == 0) {
+        throw std::invalid_argument("ConcurrentIndexer: at least one stripe per section is needed");
+    }
+    stripes = std::make_unique<Stripe[]>(NUM_SECTIONS * stripesPerSection);
+}
+
+template <typename Traits>
+typename BasicConcurrentIndexer<Traits>::Stripe& BasicConcurrentIndexer<Traits>::stripeFor(std::string_view key) const {
+    size_t first = static_cast<size_t>(getSectionIndex(key[0])) * stripesPerSection;
+    if (stripesPerSection == 1) {
+        return stripes[first];
+    }
+    return stripes[first + std::hash<std::string_view>{}(key) % stripesPerSection];
+}
+
+template <typename Traits>
+std::string BasicConcurrentIndexer<Traits>::keyFor(std::string_view token) const {
+    return caseInsensitive ? foldCase(token) : std::string(token);
+}
+
+template <typename Traits>
+void BasicConcurrentIndexer<Traits>::processToken(const std::string& token, line_type lineNumber,
+                                                  position_type position) {
+    if (token.empty()) return;
+    std::string key = keyFor(token);
+    Stripe& stripe = stripeFor(key);
+    {
+        std::unique_lock<std::shared_mutex> lock(stripe.mutex);
+        auto found = stripe.entries.find(key);
+        if (found != stripe.entries.end()) {
+            if (caseInsensitive) {
+                found->second.addSurfaceForm(token.c_str());
+            }
+            if (positional) {
+                found->second.insertLineNumber(lineNumber, position);
+            } else {
+                found->second.insertLineNumber(lineNumber);
+            }
+        } else {
+            token_type entry = positional ? token_type(token.c_str(), lineNumber, position)
+                                          : token_type(token, lineNumber);
+            if (caseInsensitive) {
+                entry.setKey(key);
+            }
+            stripe.entries.emplace(std::move(key), std::move(entry));
+        }
+    }
+    tokenCount.fetch_add(1, std::memory_order_relaxed);
+    std::uint64_t seen = lineCount.load(std::memory_order_relaxed);
+    while (lineNumber > seen && !lineCount.compare_exchange_weak(seen, lineNumber, std::memory_order_relaxed)) {
+    }
+}
+
+template <typename Traits>
+void BasicConcurrentIndexer<Traits>::processLine(const std::string& line, line_type lineNumber) {
+    std::vector<std::string> tokens = indexer_type::tokenizeLine(line);
+    position_type position = 0;
+    for (auto it = tokens.cbegin(); it != tokens.cend(); ++it) {
+        processToken(*it, lineNumber, position++);
+    }
+    std::uint64_t seen = lineCount.load(std::memory_order_relaxed);
+    while (lineNumber > seen && !lineCount.compare_exchange_weak(seen, lineNumber, std::memory_order_relaxed)) {
+    }
+}
+
+template <typename Traits>
+bool BasicConcurrentIndexer<Traits>::contains(const std::string& token) const {
+    if (token.empty()) return false;
+    std::string key = keyFor(token);
+    const Stripe& stripe = stripeFor(key);
+    std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+    return stripe.entries.find(key) != stripe.entries.end();
+}
+
+template <typename Traits>
+std::vector<typename BasicConcurrentIndexer<Traits>::line_type>
+BasicConcurrentIndexer<Traits>::occurrences(const std::string& token) const {
+    if (token.empty()) return {};
+    std::string key = keyFor(token);
+    const Stripe& stripe = stripeFor(key);
+    std::shared_lock<std::shared_mutex> lock(stripe.mutex);
+    auto found = stripe.entries.find(key);
+    if (found == stripe.entries.end()) return {};
+    return found->second.getLineNumbers();
+}
+
+template <typename Traits>
+std::vector<std::shared_lock<std::shared_mutex>> BasicConcurrentIndexer<Traits>::lockSection(int sectionIndex) const {
+    // Stripes are always taken in index order
+    std::vector<std::shared_lock<std::shared_mutex>> locks;
+    locks.reserve(stripesPerSection);
+    for (size_t i = 0; i < stripesPerSection; ++i) {
+        locks.emplace_back(stripes[static_cast<size_t>(sectionIndex) * stripesPerSection + i].mutex);
+    }
+    return locks;
+}
+
+template <typename Traits>
+std::vector<const typename BasicConcurrentIndexer<Traits>::token_type*>
+BasicConcurrentIndexer<Traits>::sectionEntries(int sectionIndex) const {
+    std::vector<const token_type*> entries;
+    for (size_t i = 0; i < stripesPerSection; ++i) {
+        const Stripe& stripe = stripes[static_cast<size_t>(sectionIndex) * stripesPerSection + i];
+        for (auto it = stripe.entries.cbegin(); it != stripe.entries.cend(); ++it) {
+            entries.push_back(&it->second);
+        }
+    }
+    if (stripesPerSection > 1) {
+        std::sort(entries.begin(), entries.end(),
+                  [](const token_type* a, const token_type* b) { return a->getKey() < b->getKey(); });
+    }
+    return entries;
+}
+
+template <typename Traits>
+std::vector<std::string> BasicConcurrentIndexer<Traits>::findPrefix(const std::string& prefix) const {
+    std::vector<std::string> keys;
+    std::string folded = keyFor(prefix);
+    int firstSection = prefix.empty() ? 0 : getSectionIndex(folded[0]);
+    int lastSection = prefix.empty() ? NUM_SECTIONS - 1 : firstSection;
+    for (int s = firstSection; s <= lastSection; ++s) {
+        size_t sectionStart = keys.size();
+        auto locks = lockSection(s);
+        for (size_t i = 0; i < stripesPerSection; ++i) {
+            const Stripe& stripe = stripes[static_cast<size_t>(s) * stripesPerSection + i];
+            for (auto it = stripe.entries.lower_bound(folded);
+                 it != stripe.entries.end() && it->first.starts_with(folded); ++it) {
+                keys.push_back(it->first);
+            }
+        }
+        std::sort(keys.begin() + static_cast<std::ptrdiff_t>(sectionStart), keys.end());
+    }
+    return keys;
+}
+
+// Displays the entire index, a section at a time
+template <typename Traits>
+void BasicConcurrentIndexer<Traits>::print(std::ostream& os) const {
+    BufferedWriter out(os);
+    for (int i = 0; i < NUM_SECTIONS; ++i) {
+        auto locks = lockSection(i);
+        std::vector<const token_type*> entries = sectionEntries(i);
+        if (entries.empty()) continue;
+        if (i < NUM_SECTIONS - 1) {
+            out << "--- Section " << static_cast<char>('A' + i) << " ---" << '\n';
+        } else {
+            out << "--- Section [Non-alphabetic] ---" << '\n';
+        }
+        for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+            (*it)->print(out);
+            out << '\n';
+        }
+        out << '\n';
+    }
+    out.flush();
+}
+
+template <typename Traits>
+void BasicConcurrentIndexer<Traits>::displaySection(int sectionIndex, std::ostream& os) const {
+    BufferedWriter out(os);
+    if (sectionIndex < 0 || sectionIndex >= NUM_SECTIONS) {
+        out << "Invalid section index: " << sectionIndex << '\n';
+        out.flush();
+        return;
+    }
+    auto locks = lockSection(sectionIndex);
+    std::vector<const token_type*> entries = sectionEntries(sectionIndex);
+    if (entries.empty()) {
+        if (sectionIndex < NUM_SECTIONS - 1) {
+            out << "Section " << static_cast<char>('A' + sectionIndex) << " is empty." << '\n';
+        } else {
+            out << "Section [Non-alphabetic] is empty." << '\n';
+        }
+    } else {
+        if (sectionIndex < NUM_SECTIONS - 1) {
+            out << "--- Section " << static_cast<char>('A' + sectionIndex) << " ---" << '\n';
+        } else {
+            out << "--- Section [Non-alphabetic] ---" << '\n';
+        }
+        for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+            (*it)->print(out);
+            out << '\n';
+        }
+    }
+    out.flush();
+}
+
+template <typename Traits>
+std::uint64_t BasicConcurrentIndexer<Traits>::getLineCount() const {
+    return lineCount.load(std::memory_order_relaxed);
+}
+
+template <typename Traits>
+std::uint64_t BasicConcurrentIndexer<Traits>::getTokenCount() const {
+    return tokenCount.load(std::memory_order_relaxed);
+}
+
+template <typename Traits>
+size_t BasicConcurrentIndexer<Traits>::getStripeCount() const {
+    return NUM_SECTIONS * stripesPerSection;
+}
+
+template class BasicConcurrentIndexer<CompactIndexTraits>;
+template class BasicConcurrentIndexer<LargeIndexTraits>;
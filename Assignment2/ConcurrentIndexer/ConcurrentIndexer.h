@@ -0,0 +1,98 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Thread-safe index with lock striping by section
+//
+
+#ifndef CONCURRENT_INDEXER_H
+#define CONCURRENT_INDEXER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+#include "../Indexer/Indexer.h"
+
+/**
+ * @class BasicConcurrentIndexer
+ * @brief An index that producer threads add to while other threads query it.
+ *
+ * Entries are split into stripes, each with its own reader/writer lock: one stripe
+ * per section, or stripesPerSection stripes per section chosen by a hash of the key
+ * so that a hot section (on skewed text, 't' or 'a') is not one lock. Adding a
+ * token locks exactly one stripe exclusively; a lookup takes one stripe shared and
+ * a section view takes that section's stripes shared.
+ *
+ * Lines may arrive in any order from any thread: postings are inserted in sorted
+ * place, so the entries match an Indexer fed the same lines in order. (In
+ * case-insensitive mode the spelling shown first is the first one to arrive.)
+ */
+template <typename Traits>
+class BasicConcurrentIndexer {
+public:
+    using indexer_type = BasicIndexer<Traits>;
+    using line_type = typename indexer_type::line_type;
+    using token_type = typename indexer_type::token_type;
+    using position_type = typename indexer_type::position_type;
+
+    static const int NUM_SECTIONS = indexer_type::NUM_SECTIONS;
+
+private:
+    // Aligned so that neighbouring stripes' locks do not share a cache line
+    struct alignas(64) Stripe {
+        mutable std::shared_mutex mutex;
+        std::map<std::string, token_type, std::less<>> entries;  // by key
+    };
+
+    size_t stripesPerSection;
+    bool positional;
+    bool caseInsensitive;
+    std::unique_ptr<Stripe[]> stripes;
+    std::atomic<std::uint64_t> lineCount{0};  // Highest line number added
+    std::atomic<std::uint64_t> tokenCount{0};
+
+    Stripe& stripeFor(std::string_view key) const;
+    std::string keyFor(std::string_view token) const;
+    // Shared locks on every stripe of a section
+    std::vector<std::shared_lock<std::shared_mutex>> lockSection(int sectionIndex) const;
+    // A section's entries in key order; caller holds its stripes
+    std::vector<const token_type*> sectionEntries(int sectionIndex) const;
+
+public:
+    explicit BasicConcurrentIndexer(size_t stripesPerSection = 1, bool positional = false,
+                                    bool caseInsensitive = false);
+
+    BasicConcurrentIndexer(const BasicConcurrentIndexer& other) = delete;
+    BasicConcurrentIndexer& operator=(const BasicConcurrentIndexer& other) = delete;
+
+    // Writers: one stripe locked per token
+    void processToken(const std::string& token, line_type lineNumber, position_type position = 0);
+    // The tokens of one line (Indexer::tokenizeLine), each at its position
+    void processLine(const std::string& line, line_type lineNumber);
+
+    // Readers: results are copied out under a shared lock
+    bool contains(const std::string& token) const;
+    std::vector<line_type> occurrences(const std::string& token) const;
+    // Keys starting with prefix, in index order
+    std::vector<std::string> findPrefix(const std::string& prefix) const;
+
+    // Same text as Indexer::print / displaySection; every section is consistent in itself
+    void print(std::ostream& os = std::cout) const;
+    void displaySection(int sectionIndex, std::ostream& os = std::cout) const;
+
+    std::uint64_t getLineCount() const;
+    std::uint64_t getTokenCount() const;
+    size_t getStripeCount() const;
+};
+
+using ConcurrentIndexer = BasicConcurrentIndexer<CompactIndexTraits>;
+using LargeConcurrentIndexer = BasicConcurrentIndexer<LargeIndexTraits>;
+
+extern template class BasicConcurrentIndexer<CompactIndexTraits>;
+extern template class BasicConcurrentIndexer<LargeIndexTraits>;
+
+#endif // CONCURRENT_INDEXER_H
@@ -0,0 +1,205 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "CorpusIndexer.h"
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+// Constructor
+template <typename Traits>
+BasicCorpusIndexer<Traits>::BasicCorpusIndexer(CorpusOptions options) : options(options) {
+    if (options.chunkBytes == 0) {
+        throw std::invalid_argument("CorpusIndexer: chunkBytes must be positive");
+    }
+}
+
+template <typename Traits>
+typename BasicCorpusIndexer<Traits>::indexer_type BasicCorpusIndexer<Traits>::emptyIndex() const {
+    indexer_type index;
+    index.setPositional(options.positional);
+    index.setCaseInsensitive(options.caseInsensitive);
+    return index;
+}
+
+template <typename Traits>
+std::unique_ptr<typename BasicCorpusIndexer<Traits>::Node>
+BasicCorpusIndexer<Traits>::group(std::vector<std::unique_ptr<Node>> nodes) {
+    while (nodes.size() > 1) {
+        std::vector<std::unique_ptr<Node>> parents;
+        for (size_t first = 0; first < nodes.size(); first += MERGE_FAN_IN) {
+            auto parent = std::make_unique<Node>();
+            for (size_t i = first; i < nodes.size() && i < first + MERGE_FAN_IN; ++i) {
+                nodes[i]->parent = parent.get();
+                parent->children.push_back(std::move(nodes[i]));
+            }
+            parent->pending = parent->children.size();
+            parents.push_back(std::move(parent));
+        }
+        nodes = std::move(parents);
+    }
+    return std::move(nodes.front());
+}
+
+template <typename Traits>
+template <typename Body>
+void BasicCorpusIndexer<Traits>::guarded(Run& run, Body body) const {
+    try {
+        body();
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(run.mutex);
+        if (!run.failure) run.failure = std::current_exception();
+    }
+}
+
+template <typename Traits>
+std::vector<std::unique_ptr<typename BasicCorpusIndexer<Traits>::Node>>
+BasicCorpusIndexer<Traits>::plan(const std::vector<std::string>& paths) const {
+    std::vector<std::unique_ptr<Node>> pieces;
+    std::unique_ptr<Node> smallFiles;  // Whole files gathered into one piece
+    std::uint64_t smallBytes = 0;
+    for (auto it = paths.cbegin(); it != paths.cend(); ++it) {
+        std::error_code error;
+        std::uint64_t size = std::filesystem::file_size(*it, error);
+        if (error) {
+            throw std::runtime_error("Could not read '" + *it + "': " + error.message());
+        }
+        if (smallFiles && (size > options.chunkBytes || smallBytes + size > options.chunkBytes)) {
+            pieces.push_back(std::move(smallFiles));
+        }
+        if (size > options.chunkBytes) {
+            for (std::uint64_t begin = 0; begin < size; begin += options.chunkBytes) {
+                auto chunk = std::make_unique<Node>();
+                chunk->ranges.push_back(Range{*it, begin, std::min(size, begin + options.chunkBytes)});
+                pieces.push_back(std::move(chunk));
+            }
+            continue;
+        }
+        if (!smallFiles) {
+            smallFiles = std::make_unique<Node>();
+            smallBytes = 0;
+        }
+        smallFiles->ranges.push_back(Range{*it, 0, size});
+        smallBytes += size;
+    }
+    if (smallFiles) {
+        pieces.push_back(std::move(smallFiles));
+    }
+    return pieces;
+}
+
+// The lines starting in the range: a line running into it belongs to the range before
+template <typename Traits>
+void BasicCorpusIndexer<Traits>::indexRange(Node* node, const Range& range) const {
+    std::ifstream file(range.path, std::ios::binary);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open '" + range.path + "'");
+    }
+    std::uint64_t position = range.begin;
+    std::string line;
+    if (position > 0) {
+        file.seekg(static_cast<std::streamoff>(position - 1));
+        char previous = 0;
+        file.get(previous);
+        if (previous != '\n') {
+            std::getline(file, line);
+            position += line.size() + 1;
+        }
+    }
+    while (position < range.end && std::getline(file, line)) {
+        position += line.size() + 1;
+        if (node->lines == std::numeric_limits<line_type>::max()) {
+            throw std::overflow_error("Line count of '" + range.path + "' exceeds the index width");
+        }
+        node->index.addLine(static_cast<line_type>(++node->lines), indexer_type::tokenizeLine(line));
+    }
+    if (file.bad()) {
+        throw std::runtime_error("Could not read '" + range.path + "'");
+    }
+}
+
+template <typename Traits>
+void BasicCorpusIndexer<Traits>::mergeChildren(Node* node) const {
+    if (node->children.size() == 1) {
+        node->index = std::move(node->children.front()->index);
+        node->lines = node->children.front()->lines;
+    } else {
+        std::vector<const indexer_type*> parts;
+        std::vector<line_type> offsets;
+        std::uint64_t lines = 0;
+        for (auto it = node->children.cbegin(); it != node->children.cend(); ++it) {
+            if (lines > std::numeric_limits<line_type>::max()) {
+                throw std::overflow_error("Corpus line count exceeds the index width; use LargeCorpusIndexer");
+            }
+            parts.push_back(&(*it)->index);
+            offsets.push_back(static_cast<line_type>(lines));
+            lines += (*it)->lines;
+        }
+        node->index = indexer_type::merged(parts, offsets);
+        node->lines = lines;
+    }
+    node->children.clear();  // The parts are no longer needed
+}
+
+template <typename Traits>
+void BasicCorpusIndexer<Traits>::finished(Run& run, Node* node) const {
+    Node* parent = node->parent;
+    if (parent == nullptr || parent->pending.fetch_sub(1) != 1) return;
+    run.pool.submit([this, &run, parent] {
+        guarded(run, [this, &run, parent] {
+            mergeChildren(parent);
+            run.merges.fetch_add(1);
+            finished(run, parent);
+        });
+    });
+}
+
+template <typename Traits>
+typename BasicCorpusIndexer<Traits>::indexer_type BasicCorpusIndexer<Traits>::indexFiles(
+    const std::vector<std::string>& paths) {
+    stats = Stats();
+    stats.files = paths.size();
+    if (paths.empty()) return emptyIndex();
+
+    std::vector<std::unique_ptr<Node>> pieces = plan(paths);
+    std::vector<Node*> leaves;
+    for (auto it = pieces.begin(); it != pieces.end(); ++it) {
+        leaves.push_back(it->get());
+    }
+    std::unique_ptr<Node> root = group(std::move(pieces));
+
+    Run run(options.threads);
+    for (auto it = leaves.begin(); it != leaves.end(); ++it) {
+        Node* leaf = *it;
+        run.pool.submit([this, &run, leaf] {
+            guarded(run, [this, &run, leaf] {
+                leaf->index = emptyIndex();
+                for (auto range = leaf->ranges.cbegin(); range != leaf->ranges.cend(); ++range) {
+                    indexRange(leaf, *range);
+                }
+                finished(run, leaf);
+            });
+        });
+    }
+    run.pool.waitIdle();
+
+    stats.pieces = leaves.size();
+    stats.merges = run.merges.load();
+    stats.workers = run.pool.getStats();
+    if (run.failure) {
+        std::rethrow_exception(run.failure);
+    }
+    return std::move(root->index);
+}
+
+template <typename Traits>
+const typename BasicCorpusIndexer<Traits>::Stats& BasicCorpusIndexer<Traits>::getStats() const {
+    return stats;
+}
+
+template class BasicCorpusIndexer<CompactIndexTraits>;
+template class BasicCorpusIndexer<LargeIndexTraits>;
@@ -0,0 +1,123 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Parallel indexing of a multi-file corpus on a work-stealing pool
+//
+
+#ifndef CORPUS_INDEXER_H
+#define CORPUS_INDEXER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../Indexer/Indexer.h"
+#include "../WorkStealingPool/WorkStealingPool.h"
+
+/**
+ * @brief Chunking and threading settings of a BasicCorpusIndexer
+ */
+struct CorpusOptions {
+    std::uint64_t chunkBytes = 4 << 20;  // Target piece size; larger files are split into chunks
+    size_t threads = 0;                  // Pool workers (0 = one per hardware thread)
+    bool positional = false;
+    bool caseInsensitive = false;
+};
+
+/**
+ * @class BasicCorpusIndexer
+ * @brief Indexes a list of files as one corpus, their lines numbered consecutively
+ * in list order (the same index as processLine over the files concatenated).
+ *
+ * The corpus is cut into pieces of about chunkBytes: a large file into line-aligned
+ * chunks (each owns the lines that start inside it), runs of small files into one
+ * piece of whole files. Each piece is a task on a WorkStealingPool, so a worker that
+ * drew small pieces steals from one still busy with large ones. Partial indexes are
+ * merged up a tree with MERGE_FAN_IN children per node (Indexer::merged, shifted by
+ * the lines before each part): a node is merged, as a task of its own, as soon as
+ * its last child finishes, while other pieces are still being indexed. Every line
+ * is rewritten once per tree level, so the tree is kept flat.
+ */
+template <typename Traits>
+class BasicCorpusIndexer {
+public:
+    using indexer_type = BasicIndexer<Traits>;
+    using line_type = typename indexer_type::line_type;
+
+    static const size_t MERGE_FAN_IN = 8;  // Partial indexes merged together
+
+    struct Stats {
+        size_t files = 0;
+        size_t pieces = 0;
+        size_t merges = 0;
+        std::vector<WorkStealingPool::WorkerStats> workers;
+    };
+
+private:
+    // Bytes [begin, end) of a file
+    struct Range {
+        std::string path;
+        std::uint64_t begin = 0;
+        std::uint64_t end = 0;
+    };
+
+    // A piece of the corpus, or the merge of consecutive pieces
+    struct Node {
+        Node* parent = nullptr;
+        std::vector<std::unique_ptr<Node>> children;  // In line order
+        std::atomic<size_t> pending{0};              // Children not finished yet
+        std::vector<Range> ranges;                    // Pieces: what to index, in order
+        indexer_type index;                           // Lines numbered from 1
+        std::uint64_t lines = 0;
+    };
+
+    // State of one indexFiles() call
+    struct Run {
+        WorkStealingPool pool;
+        std::mutex mutex;
+        std::exception_ptr failure;  // First error of any task
+        std::atomic<size_t> merges{0};
+
+        explicit Run(size_t threads) : pool(threads) {}
+    };
+
+    CorpusOptions options;
+    Stats stats;
+
+    indexer_type emptyIndex() const;
+    // The pieces of the files, in corpus order
+    std::vector<std::unique_ptr<Node>> plan(const std::vector<std::string>& paths) const;
+    // Parents of MERGE_FAN_IN consecutive nodes, repeatedly, up to a single root
+    static std::unique_ptr<Node> group(std::vector<std::unique_ptr<Node>> nodes);
+    // Runs body, recording its exception as the run's failure
+    template <typename Body>
+    void guarded(Run& run, Body body) const;
+
+    void indexRange(Node* node, const Range& range) const;
+    void mergeChildren(Node* node) const;
+    // The node is complete: merge its parent if it was the last child
+    void finished(Run& run, Node* node) const;
+
+public:
+    explicit BasicCorpusIndexer(CorpusOptions options = CorpusOptions());
+
+    /**
+     * @brief Index the files as one corpus. Throws std::runtime_error if a file
+     * cannot be read, std::overflow_error if the corpus is too large for the index width.
+     */
+    indexer_type indexFiles(const std::vector<std::string>& paths);
+
+    // Counters of the last indexFiles()
+    const Stats& getStats() const;
+};
+
+using CorpusIndexer = BasicCorpusIndexer<CompactIndexTraits>;
+using LargeCorpusIndexer = BasicCorpusIndexer<LargeIndexTraits>;
+
+extern template class BasicCorpusIndexer<CompactIndexTraits>;
+extern template class BasicCorpusIndexer<LargeIndexTraits>;
+
+#endif // CORPUS_INDEXER_H
@@ -0,0 +1,245 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "DurableIndexer.h"
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+    const char* CHECKPOINT_PREFIX = "checkpoint-";
+    const char* CHECKPOINT_SUFFIX = ".idx";
+    const char* LOG_PREFIX = "wal-";
+    const char* LOG_SUFFIX = ".log";
+    const char* PENDING_SUFFIX = ".pending";  // checkpoint written but not yet durable
+
+    // Generation number of a file named prefix + digits + suffix
+    bool parseGeneration(const std::string& name, const std::string& prefix, const std::string& suffix,
+                         std::uint64_t& generation) {
+        if (name.size() <= prefix.size() + suffix.size() || !name.starts_with(prefix) || !name.ends_with(suffix)) {
+            return false;
+        }
+        const char* first = name.data() + prefix.size();
+        const char* last = name.data() + name.size() - suffix.size();
+        auto [end, error] = std::from_chars(first, last, generation);
+        return error == std::errc() && end == last;
+    }
+
+    // fsync a file or directory, so that its contents (or names) survive a crash
+    void syncPath(const std::filesystem::path& path, bool isDirectory) {
+        int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC | (isDirectory ? O_DIRECTORY : 0));
+        if (fd < 0 || ::fsync(fd) != 0) {
+            std::string reason = std::strerror(errno);
+            if (fd >= 0) ::close(fd);
+            throw std::runtime_error("Could not sync '" + path.string() + "': " + reason);
+        }
+        ::close(fd);
+    }
+
+} // namespace
+
+// Constructor - recovers whatever the directory holds
+template <typename Traits>
+BasicDurableIndexer<Traits>::BasicDurableIndexer(const std::string& directory, DurabilityOptions options)
+    : directory(directory), options(options) {
+    std::filesystem::create_directories(this->directory);
+    recover();
+}
+
+// Destructor
+template <typename Traits>
+BasicDurableIndexer<Traits>::~BasicDurableIndexer() {
+    try {
+        commit();
+    } catch (...) {
+        // Destructors must not throw; the uncommitted lines are lost as in a crash
+    }
+}
+
+template <typename Traits>
+std::filesystem::path BasicDurableIndexer<Traits>::checkpointPath(std::uint64_t generation) const {
+    return directory / (CHECKPOINT_PREFIX + std::to_string(generation) + CHECKPOINT_SUFFIX);
+}
+
+template <typename Traits>
+std::filesystem::path BasicDurableIndexer<Traits>::logPath(std::uint64_t generation) const {
+    return directory / (LOG_PREFIX + std::to_string(generation) + LOG_SUFFIX);
+}
+
+// Recovery: newest loadable checkpoint, then every newer log in generation order;
+// throws if one of those logs is missing
+template <typename Traits>
+void BasicDurableIndexer<Traits>::recover() {
+    std::vector<std::uint64_t> checkpoints;
+    std::vector<std::uint64_t> logs;
+    for (const auto& file : std::filesystem::directory_iterator(directory)) {
+        std::string name = file.path().filename().string();
+        std::uint64_t number = 0;
+        if (parseGeneration(name, CHECKPOINT_PREFIX, CHECKPOINT_SUFFIX, number)) {
+            checkpoints.push_back(number);
+        } else if (parseGeneration(name, LOG_PREFIX, LOG_SUFFIX, number)) {
+            logs.push_back(number);
+        } else if (name.ends_with(PENDING_SUFFIX) || name.ends_with(".tmp")) {
+            std::filesystem::remove(file.path());  // an interrupted checkpoint
+        }
+    }
+    std::sort(checkpoints.begin(), checkpoints.end());
+    std::sort(logs.begin(), logs.end());
+
+    if (checkpoints.empty() && logs.empty()) {
+        // New directory: a first checkpoint records the index modes
+        index.setPositional(options.positional);
+        index.setCaseInsensitive(options.caseInsensitive);
+        index.save(checkpointPath(0).string());
+        syncPath(checkpointPath(0), false);
+        syncPath(directory, true);
+    } else {
+        bool loaded = false;
+        for (auto it = checkpoints.rbegin(); it != checkpoints.rend() && !loaded; ++it) {
+            try {
+                index.load(checkpointPath(*it).string());
+                stats.checkpointGeneration = *it;
+                loaded = true;
+            } catch (const std::runtime_error&) {
+                // Damaged; an older checkpoint plus more of the log may still cover it,
+                // if the logs in between are all still there (checked below)
+            }
+        }
+        if (!loaded) {
+            throw std::runtime_error("Could not recover the index in '" + directory.string() +
+                                     "': no readable checkpoint");
+        }
+        // Every generation after the loaded checkpoint, up to the newest file, needs
+        // its log: a newer checkpoint that could not be read may have had the logs it
+        // covers removed, and replaying around the gap would silently lose lines
+        std::uint64_t newest = std::max(checkpoints.back(), logs.empty() ? 0 : logs.back());
+        auto next = std::upper_bound(logs.begin(), logs.end(), stats.checkpointGeneration);
+        for (std::uint64_t g = stats.checkpointGeneration + 1; g <= newest; ++g, ++next) {
+            if (next == logs.end() || *next != g) {
+                throw std::runtime_error("Could not recover the index in '" + directory.string() + "': " +
+                                         logPath(g).filename().string() + " is missing after checkpoint " +
+                                         std::to_string(stats.checkpointGeneration));
+            }
+        }
+        for (auto it = logs.begin(); it != logs.end(); ++it) {
+            if (*it <= stats.checkpointGeneration) continue;
+            stats.replayedRecords += WriteAheadLog::replay(logPath(*it).string(), [this](const WriteAheadLog::Line& line) {
+                if (line.number > std::numeric_limits<line_type>::max()) {
+                    throw std::overflow_error("line number in '" + directory.string() +
+                                              "' exceeds the index width; use LargeDurableIndexer");
+                }
+                index.addLine(static_cast<line_type>(line.number), line.tokens);
+                ++stats.replayedLines;
+            });
+        }
+    }
+
+    // Continue in a log newer than every file present
+    generation = std::max(checkpoints.empty() ? 0 : checkpoints.back(), logs.empty() ? 0 : logs.back()) + 1;
+    log = std::make_unique<WriteAheadLog>(logPath(generation).string(), options.syncEvery);
+    syncPath(directory, true);
+}
+
+template <typename Traits>
+void BasicDurableIndexer<Traits>::processLine(const std::string& line) {
+    WriteAheadLog::Line entry;
+    entry.tokens = indexer_type::tokenizeLine(line);
+    if (index.getLineCount() == std::numeric_limits<line_type>::max()) {
+        throw std::overflow_error("line count exceeds the index width; use LargeDurableIndexer");
+    }
+    entry.number = static_cast<std::uint64_t>(index.getLineCount()) + 1;
+    index.addLine(static_cast<line_type>(entry.number), entry.tokens);
+    pending.push_back(std::move(entry));
+
+    if (pending.size() >= options.batchLines) {
+        flushPending();
+        if (options.checkpointEvery != 0 && recordsSinceCheckpoint >= options.checkpointEvery) {
+            checkpoint();
+        }
+    }
+}
+
+template <typename Traits>
+void BasicDurableIndexer<Traits>::processTextFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file '" + filename + "'");
+    }
+    std::string line;
+    while (std::getline(file, line)) {
+        processLine(line);
+    }
+    commit();
+}
+
+template <typename Traits>
+void BasicDurableIndexer<Traits>::flushPending() {
+    if (pending.empty()) return;
+    log->append(pending);
+    pending.clear();
+    ++recordsSinceCheckpoint;
+}
+
+template <typename Traits>
+void BasicDurableIndexer<Traits>::commit() {
+    flushPending();
+    log->sync();
+}
+
+// The new log is opened before the index is saved, so every line lands either in
+// the checkpoint or in a log newer than it. The checkpoint becomes visible under
+// its final name only once it is on disk; older files are removed after that.
+template <typename Traits>
+void BasicDurableIndexer<Traits>::checkpoint() {
+    commit();
+    std::uint64_t covered = generation;
+    auto next = std::make_unique<WriteAheadLog>(logPath(covered + 1).string(), options.syncEvery);
+
+    std::filesystem::path written = checkpointPath(covered);
+    written += PENDING_SUFFIX;
+    index.save(written.string());
+    syncPath(written, false);
+    std::filesystem::rename(written, checkpointPath(covered));
+    syncPath(directory, true);
+
+    log = std::move(next);
+    generation = covered + 1;
+    recordsSinceCheckpoint = 0;
+    stats.checkpointGeneration = covered;
+    ++stats.checkpoints;
+
+    for (const auto& file : std::filesystem::directory_iterator(directory)) {
+        std::string name = file.path().filename().string();
+        std::uint64_t number = 0;
+        if ((parseGeneration(name, CHECKPOINT_PREFIX, CHECKPOINT_SUFFIX, number) && number < covered) ||
+            (parseGeneration(name, LOG_PREFIX, LOG_SUFFIX, number) && number <= covered)) {
+            std::filesystem::remove(file.path());
+        }
+    }
+}
+
+template <typename Traits>
+const typename BasicDurableIndexer<Traits>::indexer_type& BasicDurableIndexer<Traits>::getIndex() const {
+    return index;
+}
+
+template <typename Traits>
+typename BasicDurableIndexer<Traits>::Stats BasicDurableIndexer<Traits>::getStats() const {
+    Stats current = stats;
+    WriteAheadLog::Stats logStats = log->getStats();
+    current.logRecords = logStats.records;
+    current.logSyncs = logStats.syncs;
+    return current;
+}
+
+template class BasicDurableIndexer<CompactIndexTraits>;
+template class BasicDurableIndexer<LargeIndexTraits>;
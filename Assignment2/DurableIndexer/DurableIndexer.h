@@ -0,0 +1,107 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Crash-safe incremental indexing: write-ahead log plus periodic checkpoints
+//
+
+#ifndef DURABLE_INDEXER_H
+#define DURABLE_INDEXER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Indexer/Indexer.h"
+#include "../WriteAheadLog/WriteAheadLog.h"
+
+/**
+ * @brief Batching and durability settings of a BasicDurableIndexer
+ */
+struct DurabilityOptions {
+    size_t batchLines = 256;        // Lines per log record
+    size_t syncEvery = 16;          // Log records per fdatasync (0: leave it to the OS and commit())
+    size_t checkpointEvery = 4096;  // Log records between automatic checkpoints (0: only checkpoint())
+    bool positional = false;        // Modes of a new index; a recovered one keeps its own
+    bool caseInsensitive = false;
+};
+
+/**
+ * @class BasicDurableIndexer
+ * @brief An index kept in a directory so that a crash costs at most the lines
+ * not yet committed, never a rebuild.
+ *
+ * Every indexed line goes to the in-memory index and, in batches, to a write-ahead
+ * log (WriteAheadLog). A checkpoint saves the index (Indexer::save) and retires the
+ * logs it covers. Files are numbered by generation:
+ *   checkpoint-<g>.idx  the index after every log up to generation g
+ *   wal-<g>.log         lines indexed after checkpoint g-1 was started
+ * Opening the directory recovers: the newest readable checkpoint is loaded and the
+ * newer logs are replayed in order; indexing then continues in a fresh log. If a
+ * damaged checkpoint forces an older one, every log after it must still be there.
+ */
+template <typename Traits>
+class BasicDurableIndexer {
+public:
+    using indexer_type = BasicIndexer<Traits>;
+    using line_type = typename indexer_type::line_type;
+
+    struct Stats {
+        std::uint64_t checkpointGeneration = 0;  // Generation of the newest checkpoint
+        std::uint64_t replayedRecords = 0;       // Log records applied when the directory was opened
+        std::uint64_t replayedLines = 0;
+        std::uint64_t logRecords = 0;            // Appended to the current log
+        std::uint64_t logSyncs = 0;
+        std::uint64_t checkpoints = 0;           // Taken since the directory was opened
+    };
+
+private:
+    std::filesystem::path directory;
+    DurabilityOptions options;
+    indexer_type index;
+    std::uint64_t generation = 0;             // Generation of the active log
+    std::unique_ptr<WriteAheadLog> log;
+    std::vector<WriteAheadLog::Line> pending;  // Indexed lines not yet in the log
+    size_t recordsSinceCheckpoint = 0;
+    Stats stats;
+
+    std::filesystem::path checkpointPath(std::uint64_t generation) const;
+    std::filesystem::path logPath(std::uint64_t generation) const;
+    void recover();
+    void flushPending();
+
+public:
+    /**
+     * @brief Open (creating if needed) the index kept in directory, recovering its
+     * last committed state. Throws std::runtime_error if it cannot be recovered.
+     */
+    explicit BasicDurableIndexer(const std::string& directory, DurabilityOptions options = DurabilityOptions());
+
+    BasicDurableIndexer(const BasicDurableIndexer& other) = delete;
+    BasicDurableIndexer& operator=(const BasicDurableIndexer& other) = delete;
+
+    // Commits outstanding lines
+    ~BasicDurableIndexer();
+
+    // Index text as the next line; it is durable once its batch is logged and synced
+    void processLine(const std::string& line);
+    // Every line of a text file, then a commit
+    void processTextFile(const std::string& filename);
+
+    // Log the lines still buffered and sync the log: everything indexed so far survives a crash
+    void commit();
+
+    // Save the index and retire the logs it covers, bounding recovery time and disk use
+    void checkpoint();
+
+    const indexer_type& getIndex() const;
+    Stats getStats() const;
+};
+
+using DurableIndexer = BasicDurableIndexer<CompactIndexTraits>;
+using LargeDurableIndexer = BasicDurableIndexer<LargeIndexTraits>;
+
+extern template class BasicDurableIndexer<CompactIndexTraits>;
+extern template class BasicDurableIndexer<LargeIndexTraits>;
+
+#endif // DURABLE_INDEXER_H
@@ -0,0 +1,309 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "FrontCodedDictionary.h"
+#include "../ByteCoding/ByteCoding.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+
+    const size_t HEADER_SIZE = 2 * sizeof(std::uint64_t);  // count, blockCount
+    const size_t OFFSET_SIZE = sizeof(std::uint32_t);        // one block offset
+    // Lengths byte of a non-head key: shared prefix in the high nibble, suffix length
+    // in the low one; ESCAPE means both follow as varints instead
+    const unsigned char ESCAPE = 0xF0;
+
+    std::runtime_error corrupt(const std::string& reason) {
+        return std::runtime_error("Corrupt front-coded dictionary: " + reason);
+    }
+
+    // LEB128 value at data[offset], never reading at or past end
+    std::uint64_t readLength(const char* data, size_t end, size_t& offset) {
+        std::uint64_t value = 0;
+        if (!readVarint(data, end, offset, value)) {
+            throw corrupt("truncated or overlong length");
+        }
+        return value;
+    }
+
+    // Bytes [offset, offset + length) of the block data, checked against end
+    std::string_view readBytes(const char* data, size_t end, size_t& offset, std::uint64_t length) {
+        if (length > end - offset) {
+            throw corrupt("key runs past its block");
+        }
+        std::string_view bytes(data + offset, static_cast<size_t>(length));
+        offset += static_cast<size_t>(length);
+        return bytes;
+    }
+
+} // namespace
+
+std::string FrontCodedDictionary::encode(const std::vector<std::string_view>& sortedKeys) {
+    size_t blockTotal = (sortedKeys.size() + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    std::string blockData;
+    std::vector<std::uint32_t> blockOffsets;
+    blockOffsets.reserve(blockTotal);
+
+    std::string_view previous;
+    for (auto it = sortedKeys.begin(); it != sortedKeys.end(); ++it) {
+        std::string_view key = *it;
+        if (it != sortedKeys.begin() && key <= previous) {
+            throw std::invalid_argument("FrontCodedDictionary::encode: keys must be sorted and unique");
+        }
+        if (static_cast<size_t>(it - sortedKeys.begin()) % BLOCK_SIZE == 0) {
+            // Block head, stored in full
+            if (blockData.size() > std::numeric_limits<std::uint32_t>::max()) {
+                throw std::length_error("FrontCodedDictionary::encode: more than 4 GiB of keys");
+            }
+            blockOffsets.push_back(static_cast<std::uint32_t>(blockData.size()));
+            appendVarint(blockData, key.size());
+            blockData.append(key);
+        } else {
+            size_t limit = std::min(previous.size(), key.size());
+            size_t shared = static_cast<size_t>(
+                std::mismatch(key.begin(), key.begin() + static_cast<std::ptrdiff_t>(limit), previous.begin()).first -
+                key.begin());
+            size_t suffix = key.size() - shared;
+            if (shared < 0xF && suffix <= 0xF) {
+                blockData.push_back(static_cast<char>(shared << 4 | suffix));
+            } else {
+                blockData.push_back(static_cast<char>(ESCAPE));
+                appendVarint(blockData, shared);
+                appendVarint(blockData, suffix);
+            }
+            blockData.append(key.substr(shared));
+        }
+        previous = key;
+    }
+
+    std::string encoded;
+    encoded.reserve(HEADER_SIZE + blockOffsets.size() * OFFSET_SIZE + blockData.size());
+    appendWord<std::uint64_t>(encoded, sortedKeys.size());
+    appendWord<std::uint64_t>(encoded, blockOffsets.size());
+    for (auto it = blockOffsets.begin(); it != blockOffsets.end(); ++it) {
+        appendWord(encoded, *it);
+    }
+    encoded.append(blockData);
+    return encoded;
+}
+
+FrontCodedDictionary::FrontCodedDictionary(std::string encoded) : owned(std::move(encoded)) {
+    attach(owned.data(), owned.size());
+}
+
+FrontCodedDictionary FrontCodedDictionary::view(const char* data, size_t size) {
+    FrontCodedDictionary dictionary;
+    dictionary.attach(data, size);
+    return dictionary;
+}
+
+void FrontCodedDictionary::attach(const char* data, size_t size) {
+    // Only the fixed part is checked here; block offsets are checked as blocks are read
+    if (size < HEADER_SIZE) {
+        throw corrupt("too short");
+    }
+    count = readWord<std::uint64_t>(data);
+    blockCount = readWord<std::uint64_t>(data + sizeof(std::uint64_t));
+    if (blockCount != count / BLOCK_SIZE + (count % BLOCK_SIZE != 0) || blockCount > (size - HEADER_SIZE) / OFFSET_SIZE) {
+        throw corrupt("block table does not match the key count");
+    }
+    offsets = data + HEADER_SIZE;
+    blocks = offsets + blockCount * OFFSET_SIZE;
+    blocksSize = size - HEADER_SIZE - static_cast<size_t>(blockCount) * OFFSET_SIZE;
+}
+
+FrontCodedDictionary::FrontCodedDictionary(const FrontCodedDictionary& other)
+    : owned(other.owned), blocks(other.blocks), blocksSize(other.blocksSize), offsets(other.offsets),
+      count(other.count), blockCount(other.blockCount) {
+    if (!owned.empty()) {
+        attach(owned.data(), owned.size());
+    }
+}
+
+FrontCodedDictionary& FrontCodedDictionary::operator=(const FrontCodedDictionary& other) {
+    if (this != &other) {
+        FrontCodedDictionary copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+FrontCodedDictionary::FrontCodedDictionary(FrontCodedDictionary&& other) noexcept
+    : owned(std::move(other.owned)), blocks(other.blocks), blocksSize(other.blocksSize), offsets(other.offsets),
+      count(other.count), blockCount(other.blockCount) {
+    if (!owned.empty()) {
+        // A short string's bytes move with the object; re-point at them
+        offsets = owned.data() + HEADER_SIZE;
+        blocks = offsets + blockCount * OFFSET_SIZE;
+    }
+    other = FrontCodedDictionary();
+}
+
+FrontCodedDictionary& FrontCodedDictionary::operator=(FrontCodedDictionary&& other) noexcept {
+    if (this != &other) {
+        owned = std::move(other.owned);
+        blocks = other.blocks;
+        blocksSize = other.blocksSize;
+        offsets = other.offsets;
+        count = other.count;
+        blockCount = other.blockCount;
+        if (!owned.empty()) {
+            offsets = owned.data() + HEADER_SIZE;
+            blocks = offsets + blockCount * OFFSET_SIZE;
+        }
+        other.owned.clear();
+        other.blocks = other.offsets = nullptr;
+        other.blocksSize = 0;
+        other.count = other.blockCount = 0;
+    }
+    return *this;
+}
+
+size_t FrontCodedDictionary::blockStart(std::uint64_t block) const {
+    std::uint32_t start = readWord<std::uint32_t>(offsets + block * OFFSET_SIZE);
+    if (start >= blocksSize) {
+        throw corrupt("block offset outside the dictionary");
+    }
+    return static_cast<size_t>(start);
+}
+
+size_t FrontCodedDictionary::blockEnd(std::uint64_t block) const {
+    if (block + 1 == blockCount) {
+        return blocksSize;
+    }
+    std::uint32_t end = readWord<std::uint32_t>(offsets + (block + 1) * OFFSET_SIZE);
+    if (end > blocksSize) {
+        throw corrupt("block offset outside the dictionary");
+    }
+    return static_cast<size_t>(end);
+}
+
+std::string_view FrontCodedDictionary::blockHead(std::uint64_t block) const {
+    size_t offset = blockStart(block);
+    size_t end = blockEnd(block);
+    if (end < offset) {
+        throw corrupt("block offsets out of order");
+    }
+    std::uint64_t length = readLength(blocks, end, offset);
+    return readBytes(blocks, end, offset, length);
+}
+
+std::uint64_t FrontCodedDictionary::findBlock(std::string_view key) const {
+    // First head > key; key would sit in the block before it
+    std::uint64_t lo = 0;
+    std::uint64_t hi = blockCount;
+    while (lo < hi) {
+        std::uint64_t mid = lo + (hi - lo) / 2;
+        if (blockHead(mid) <= key) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+size_t FrontCodedDictionary::size() const {
+    return static_cast<size_t>(count);
+}
+
+bool FrontCodedDictionary::empty() const {
+    return count == 0;
+}
+
+size_t FrontCodedDictionary::encodedSize() const {
+    return blocks == nullptr ? 0 : HEADER_SIZE + static_cast<size_t>(blockCount) * OFFSET_SIZE + blocksSize;
+}
+
+std::string FrontCodedDictionary::at(size_t ordinal) const {
+    if (ordinal >= count) {
+        throw std::out_of_range("FrontCodedDictionary::at: ordinal " + std::to_string(ordinal) + " out of range");
+    }
+    Cursor keys = cursor(ordinal);
+    return keys.next();
+}
+
+std::pair<size_t, bool> FrontCodedDictionary::locate(std::string_view key) const {
+    std::uint64_t after = findBlock(key);
+    if (after == 0) {
+        return {0, false};  // before the first head
+    }
+    std::uint64_t first = (after - 1) * BLOCK_SIZE;
+    std::uint64_t last = std::min(first + BLOCK_SIZE, count);
+    Cursor keys = cursor(static_cast<size_t>(first));
+    for (std::uint64_t ordinal = first; ordinal < last; ++ordinal) {
+        int order = std::string_view(keys.next()).compare(key);
+        if (order >= 0) {
+            return {static_cast<size_t>(ordinal), order == 0};
+        }
+    }
+    return {static_cast<size_t>(last), false};
+}
+
+std::optional<size_t> FrontCodedDictionary::find(std::string_view key) const {
+    auto [ordinal, found] = locate(key);
+    if (!found) {
+        return std::nullopt;
+    }
+    return ordinal;
+}
+
+size_t FrontCodedDictionary::lowerBound(std::string_view key) const {
+    return locate(key).first;
+}
+
+FrontCodedDictionary::Cursor FrontCodedDictionary::cursor(size_t first) const {
+    return Cursor(*this, first);
+}
+
+FrontCodedDictionary::Cursor::Cursor(const FrontCodedDictionary& dictionary, std::uint64_t first)
+    : dictionary(&dictionary), ordinal(first / BLOCK_SIZE * BLOCK_SIZE) {
+    // Keys are rebuilt from their block head, so start there and decode up to first
+    while (ordinal < first && hasNext()) {
+        next();
+    }
+}
+
+bool FrontCodedDictionary::Cursor::hasNext() const {
+    return ordinal < dictionary->count;
+}
+
+const std::string& FrontCodedDictionary::Cursor::next() {
+    if (!hasNext()) {
+        throw std::out_of_range("FrontCodedDictionary::Cursor::next: past the last key");
+    }
+    std::uint64_t block = ordinal / BLOCK_SIZE;
+    size_t end = dictionary->blockEnd(block);
+    if (ordinal % BLOCK_SIZE == 0) {
+        offset = dictionary->blockStart(block);
+        if (end < offset) {
+            throw corrupt("block offsets out of order");
+        }
+        std::uint64_t length = readLength(dictionary->blocks, end, offset);
+        current.assign(readBytes(dictionary->blocks, end, offset, length));
+    } else {
+        if (offset >= end) {
+            throw corrupt("truncated length");
+        }
+        unsigned char lengths = static_cast<unsigned char>(dictionary->blocks[offset++]);
+        std::uint64_t shared = lengths >> 4;
+        std::uint64_t suffix = lengths & 0xF;
+        if (lengths == ESCAPE) {
+            shared = readLength(dictionary->blocks, end, offset);
+            suffix = readLength(dictionary->blocks, end, offset);
+        } else if (shared == 0xF) {
+            throw corrupt("invalid length byte");
+        }
+        if (shared > current.size()) {
+            throw corrupt("shared prefix longer than the previous key");
+        }
+        current.resize(static_cast<size_t>(shared));
+        current.append(readBytes(dictionary->blocks, end, offset, suffix));
+    }
+    ++ordinal;
+    return current;
+}
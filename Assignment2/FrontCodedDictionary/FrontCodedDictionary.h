@@ -0,0 +1,108 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Front-coded (prefix-compressed) sorted string dictionary
+//
+
+#ifndef FRONT_CODED_DICTIONARY_H
+#define FRONT_CODED_DICTIONARY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+/**
+ * @class FrontCodedDictionary
+ * @brief Sorted keys stored in blocks of BLOCK_SIZE: the first key of a block
+ * in full, every other key as (length shared with the previous key, suffix).
+ * A table of block offsets samples the first key of every block, so a lookup
+ * is a binary search over block heads plus a scan of one block.
+ *
+ * Encoded form (little-endian, usable in place from a mapped file):
+ *   u64 count, u64 blockCount, u32 blockOffsets[blockCount] (from the block data),
+ *   block data: varint length + bytes for a head; for the rest one byte holding
+ *   shared (high nibble) and suffix length (low nibble), or 0xF0 followed by both
+ *   as varints when either does not fit, then the suffix bytes. Varints are LEB128.
+ * Corrupt data is reported with std::runtime_error, never read out of bounds.
+ */
+class FrontCodedDictionary {
+public:
+    static constexpr size_t BLOCK_SIZE = 16;
+
+private:
+    std::string owned;                   // Encoded bytes when this object owns them
+    const char* blocks = nullptr;        // Start of the block data
+    size_t blocksSize = 0;
+    const char* offsets = nullptr;       // blockCount u32 offsets (possibly unaligned)
+    std::uint64_t count = 0;
+    std::uint64_t blockCount = 0;
+
+    void attach(const char* data, size_t size);
+    size_t blockStart(std::uint64_t block) const;
+    size_t blockEnd(std::uint64_t block) const;
+    // Head key of a block, as a view into the block data
+    std::string_view blockHead(std::uint64_t block) const;
+    // Number of blocks whose head is <= key (binary search over the heads)
+    std::uint64_t findBlock(std::string_view key) const;
+    // First ordinal whose key is >= key, and whether it equals key
+    std::pair<size_t, bool> locate(std::string_view key) const;
+
+public:
+    /**
+     * @class Cursor
+     * @brief Sequential decoder: each next() rebuilds one key from the previous one
+     */
+    class Cursor {
+    private:
+        const FrontCodedDictionary* dictionary;
+        std::uint64_t ordinal;  // Ordinal of the next key
+        size_t offset = 0;      // Read position in the block data
+        std::string current;
+
+    public:
+        // Positioned before key `first` (decodes from the start of its block)
+        Cursor(const FrontCodedDictionary& dictionary, std::uint64_t first);
+        bool hasNext() const;
+        const std::string& next();
+    };
+
+    FrontCodedDictionary() = default;
+
+    /**
+     * @brief Encode keys, which must be sorted and free of duplicates
+     */
+    static std::string encode(const std::vector<std::string_view>& sortedKeys);
+
+    // Owns a copy of encoded bytes
+    explicit FrontCodedDictionary(std::string encoded);
+
+    /**
+     * @brief View over encoded bytes owned elsewhere (e.g. a mapped file)
+     */
+    static FrontCodedDictionary view(const char* data, size_t size);
+
+    // A view must not outlive its bytes; an owning copy re-points at its own copy
+    FrontCodedDictionary(const FrontCodedDictionary& other);
+    FrontCodedDictionary& operator=(const FrontCodedDictionary& other);
+    FrontCodedDictionary(FrontCodedDictionary&& other) noexcept;
+    FrontCodedDictionary& operator=(FrontCodedDictionary&& other) noexcept;
+    ~FrontCodedDictionary() = default;
+
+    size_t size() const;
+    bool empty() const;
+    size_t encodedSize() const;
+
+    // Key with the given ordinal (decodes at most one block)
+    std::string at(size_t ordinal) const;
+    // Ordinal of key, if present
+    std::optional<size_t> find(std::string_view key) const;
+    // Ordinal of the first key >= key (size() if none)
+    size_t lowerBound(std::string_view key) const;
+
+    Cursor cursor(size_t first = 0) const;
+};
+
+#endif // FRONT_CODED_DICTIONARY_H
@@ -0,0 +1,153 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "IndexExporter.h"
+#include "../ByteCoding/ByteCoding.h"
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+    char sectionName(int section) {
+        return section < 26 ? static_cast<char>('A' + section) : '*';
+    }
+
+    void writeJsonString(BufferedWriter& out, std::string_view text) {
+        static const char HEX[] = "0123456789abcdef";
+        out.put('"');
+        for (char c : text) {
+            unsigned char byte = static_cast<unsigned char>(c);
+            switch (c) {
+                case '"': out.write("\\\""); break;
+                case '\\': out.write("\\\\"); break;
+                case '\n': out.write("\\n"); break;
+                case '\r': out.write("\\r"); break;
+                case '\t': out.write("\\t"); break;
+                default:
+                    if (byte < 0x20) {
+                        out.write("\\u00");
+                        out.put(HEX[byte >> 4]);
+                        out.put(HEX[byte & 0xF]);
+                    } else {
+                        out.put(c);
+                    }
+            }
+        }
+        out.put('"');
+    }
+
+    void writeCsvField(BufferedWriter& out, std::string_view text) {
+        if (text.find_first_of(",\"\r\n") == std::string_view::npos) {
+            out.write(text);
+            return;
+        }
+        out.put('"');
+        for (char c : text) {
+            if (c == '"') out.put('"');  // quotes are doubled
+            out.put(c);
+        }
+        out.put('"');
+    }
+
+    void writeVarint(BufferedWriter& out, std::uint64_t value) {
+        char bytes[MAX_VARINT_SIZE];
+        out.write(std::string_view(bytes, encodeVarint(value, bytes)));
+    }
+
+} // namespace
+
+ExportFormat parseExportFormat(std::string_view name) {
+    std::string lower = foldCase(name);
+    if (lower == "jsonl" || lower == "json") return ExportFormat::JsonLines;
+    if (lower == "csv") return ExportFormat::Csv;
+    if (lower == "bin" || lower == "binary") return ExportFormat::Binary;
+    throw std::invalid_argument("unknown export format '" + std::string(name) + "' (expected jsonl, csv or bin)");
+}
+
+// Constructor
+template <typename Traits>
+BasicIndexExporter<Traits>::BasicIndexExporter(const indexer_type& indexer) : indexer(indexer) {}
+
+template <typename Traits>
+void BasicIndexExporter<Traits>::writeJsonLines(BufferedWriter& out) const {
+    for (const auto& entry : indexer.range("", "")) {
+        out << "{\"section\":\"" << sectionName(getSectionIndex(entry.getKey()[0])) << "\",\"token\":";
+        writeJsonString(out, entry.getToken());
+        if (!entry.getSurfaceForms().empty()) {
+            out << ",\"forms\":[";
+            for (auto it = entry.getSurfaceForms().cbegin(); it != entry.getSurfaceForms().cend(); ++it) {
+                if (it != entry.getSurfaceForms().cbegin()) out.put(',');
+                writeJsonString(out, *it);
+            }
+            out.put(']');
+        }
+        out << ",\"lines\":[";
+        out.writeNumbers(std::span<const typename indexer_type::line_type>(entry.getLineNumbers()), ',');
+        out << "]}\n";
+    }
+}
+
+template <typename Traits>
+void BasicIndexExporter<Traits>::writeCsv(BufferedWriter& out) const {
+    out << "section,token,count,lines\n";
+    for (const auto& entry : indexer.range("", "")) {
+        out << sectionName(getSectionIndex(entry.getKey()[0])) << ',';
+        writeCsvField(out, entry.getToken());
+        out << ',' << entry.getLineNumbers().size() << ',';
+        out.writeNumbers(std::span<const typename indexer_type::line_type>(entry.getLineNumbers()));
+        out.put('\n');
+    }
+}
+
+template <typename Traits>
+void BasicIndexExporter<Traits>::writeBinary(BufferedWriter& out) const {
+    out.write("C5IX");
+    out.put(static_cast<char>(BINARY_VERSION));
+    out.put(static_cast<char>(sizeof(typename indexer_type::line_type)));
+    for (const auto& entry : indexer.range("", "")) {
+        writeVarint(out, static_cast<std::uint64_t>(getSectionIndex(entry.getKey()[0])));
+        writeVarint(out, entry.getToken().size());
+        out.write(entry.getToken());
+        const auto& lines = entry.getLineNumbers();
+        writeVarint(out, lines.size());
+        typename indexer_type::line_type previous = 0;
+        for (auto it = lines.cbegin(); it != lines.cend(); ++it) {
+            writeVarint(out, *it - previous);
+            previous = *it;
+        }
+    }
+}
+
+template <typename Traits>
+void BasicIndexExporter<Traits>::write(BufferedWriter& out, ExportFormat format) const {
+    switch (format) {
+        case ExportFormat::JsonLines: writeJsonLines(out); break;
+        case ExportFormat::Csv: writeCsv(out); break;
+        case ExportFormat::Binary: writeBinary(out); break;
+    }
+}
+
+template <typename Traits>
+void BasicIndexExporter<Traits>::write(std::ostream& os, ExportFormat format) const {
+    BufferedWriter out(os);
+    write(out, format);
+    out.flush();
+}
+
+template <typename Traits>
+void BasicIndexExporter<Traits>::writeFile(const std::string& filename, ExportFormat format) const {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open export file: " + filename);
+    }
+    write(file, format);
+    if (!file) {
+        throw std::runtime_error("Failed writing export file: " + filename);
+    }
+}
+
+// Explicit instantiations for the supported index widths
+template class BasicIndexExporter<CompactIndexTraits>;
+template class BasicIndexExporter<LargeIndexTraits>;
@@ -0,0 +1,75 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Machine-readable exports of an index
+//
+
+#ifndef INDEX_EXPORTER_H
+#define INDEX_EXPORTER_H
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include "../BufferedWriter/BufferedWriter.h"
+#include "../Indexer/Indexer.h"
+
+/**
+ * @brief Export formats. Every format lists the entries in index order.
+ *
+ * JsonLines: one object per entry, e.g.
+ *   {"section":"C","token":"Chuck","forms":["CHUCK"],"lines":[1,5,8]}
+ *   ("forms" only when the index folds case and other spellings were seen)
+ * Csv: header "section,token,count,lines", lines space separated; fields
+ *   are quoted (RFC 4180) when they contain a comma, quote or line break
+ * Binary: "C5IX", format version and line width as single bytes, then per entry
+ *   varint section (0-26), varint token length, token bytes, varint posting
+ *   count, varint line gaps (first gap from 0). Varints are LEB128.
+ * Sections are named A-Z, and * for non-alphabetic tokens.
+ */
+enum class ExportFormat { JsonLines, Csv, Binary };
+
+/**
+ * @brief Format from its name: "jsonl" / "json", "csv", "bin" / "binary" (any case).
+ * Throws std::invalid_argument for anything else.
+ */
+ExportFormat parseExportFormat(std::string_view name);
+
+/**
+ * @class BasicIndexExporter
+ * @brief Streams an index in one of the export formats. Entries are visited
+ * with the index's range iterator and written straight into a buffered sink,
+ * so the export is never held in memory as a whole.
+ */
+template <typename Traits>
+class BasicIndexExporter {
+public:
+    using indexer_type = BasicIndexer<Traits>;
+
+    static const unsigned char BINARY_VERSION = 1;
+
+private:
+    const indexer_type& indexer;
+
+    void writeJsonLines(BufferedWriter& out) const;
+    void writeCsv(BufferedWriter& out) const;
+    void writeBinary(BufferedWriter& out) const;
+
+public:
+    // The index must outlive the exporter and must not change during an export
+    explicit BasicIndexExporter(const indexer_type& indexer);
+
+    void write(BufferedWriter& out, ExportFormat format) const;
+    void write(std::ostream& os, ExportFormat format) const;
+
+    /**
+     * @brief Export to a file (created or truncated); throws std::runtime_error if it cannot be written
+     */
+    void writeFile(const std::string& filename, ExportFormat format) const;
+};
+
+using IndexExporter = BasicIndexExporter<CompactIndexTraits>;
+using LargeIndexExporter = BasicIndexExporter<LargeIndexTraits>;
+
+extern template class BasicIndexExporter<CompactIndexTraits>;
+extern template class BasicIndexExporter<LargeIndexTraits>;
+
+#endif // INDEX_EXPORTER_H
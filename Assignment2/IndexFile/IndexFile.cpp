@@ -0,0 +1,174 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "IndexFile.h"
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+
+static_assert(std::endian::native == std::endian::little, "index files are read and written in place as little-endian");
+
+void IndexFile::Checksum::mix(std::uint64_t word) {
+    hash = std::rotl(hash ^ word, 29) * 0xBF58476D1CE4E5B9ull;
+}
+
+void IndexFile::Checksum::update(const void* data, size_t size) {
+    if (size == 0) return;  // data may be null
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    length += size;
+    // Complete a word left over from the previous call
+    if (pendingSize != 0) {
+        size_t take = std::min(size, sizeof(pending) - pendingSize);
+        std::memcpy(pending + pendingSize, bytes, take);
+        pendingSize += take;
+        bytes += take;
+        size -= take;
+        if (pendingSize == sizeof(pending)) {
+            std::uint64_t word;
+            std::memcpy(&word, pending, 8);
+            mix(word);
+            pendingSize = 0;
+        }
+    }
+    for (; size >= 8; bytes += 8, size -= 8) {
+        std::uint64_t word;
+        std::memcpy(&word, bytes, 8);
+        mix(word);
+    }
+    std::memcpy(pending + pendingSize, bytes, size);  // size is 0 unless pending was empty
+    pendingSize += size;
+}
+
+std::uint64_t IndexFile::Checksum::value() const {
+    std::uint64_t tail = 0;
+    std::memcpy(&tail, pending, pendingSize);
+    std::uint64_t result = std::rotl(hash ^ tail ^ length, 29) * 0xBF58476D1CE4E5B9ull;
+    // Final avalanche (splitmix64)
+    result ^= result >> 31;
+    result *= 0x94D049BB133111EBull;
+    result ^= result >> 29;
+    return result;
+}
+
+std::uint64_t IndexFile::checksum(const void* data, size_t size) {
+    Checksum sum;
+    sum.update(data, size);
+    return sum.value();
+}
+
+bool IndexFile::entryInBounds(const Header& header, const Entry& entry) {
+    std::uint64_t postingsCapacity = header.postings.size / header.lineWidth;
+    return entry.keyLength != 0 && entry.stringsOffset <= header.strings.size &&
+           entry.tokenLength <= header.strings.size - entry.stringsOffset &&
+           entry.postingsOffset <= postingsCapacity && entry.postingsCount <= postingsCapacity - entry.postingsOffset &&
+           entry.positionsOffset <= header.positions.size &&
+           entry.positionsSize <= header.positions.size - entry.positionsOffset;
+}
+
+FrontCodedDictionary IndexFile::sectionDictionary(const void* data, const Header& header, const Section& section) {
+    const char* region = static_cast<const char*>(data) + header.dictionary.offset;
+    return FrontCodedDictionary::view(region + section.dictionaryOffset, section.dictionarySize);
+}
+
+const IndexFile::Header& IndexFile::validate(const void* data, size_t size, const std::string& path, Verify level) {
+    auto fail = [&](const std::string& reason) {
+        return std::runtime_error("Invalid index file '" + path + "': " + reason);
+    };
+    if (size < sizeof(Header)) {
+        throw fail("too short for a header");
+    }
+    const unsigned char* base = static_cast<const unsigned char*>(data);
+    const Header& header = *reinterpret_cast<const Header*>(base);
+
+    if (header.magic != MAGIC) {
+        throw fail("not an index file");
+    }
+    if (header.version != VERSION) {
+        throw fail("format version " + std::to_string(header.version) + " is not supported (expected " +
+                   std::to_string(VERSION) + ")");
+    }
+    if (header.headerChecksum != checksum(base, offsetof(Header, headerChecksum))) {
+        throw fail("header checksum mismatch");
+    }
+    if (header.lineWidth != 4 && header.lineWidth != 8) {
+        throw fail("unsupported line number width " + std::to_string(header.lineWidth));
+    }
+    if (header.fileSize != size) {
+        throw fail("size is " + std::to_string(size) + " bytes, header records " + std::to_string(header.fileSize));
+    }
+
+    // Every region must lie inside the file and start aligned
+    const Extent* extents[] = {&header.filename, &header.directory, &header.entries, &header.dictionary,
+                               &header.strings, &header.postings, &header.positions};
+    for (const Extent* extent : extents) {
+        if (extent->offset % ALIGNMENT != 0 || extent->offset > size || extent->size > size - extent->offset) {
+            throw fail("region outside the file");
+        }
+    }
+    if (header.entryCount > size / sizeof(Entry) || header.directory.size != SECTION_COUNT * sizeof(Section) ||
+        header.entries.size != header.entryCount * sizeof(Entry) ||
+        header.postings.size % header.lineWidth != 0) {
+        throw fail("region sizes do not match the header counts");
+    }
+
+    // Entry ranges must tile the entry table in section order (the directory is small,
+    // so its checksum is part of the layout check)
+    if (checksum(base + header.directory.offset, header.directory.size) != header.directoryChecksum) {
+        throw fail("section directory checksum mismatch");
+    }
+    const Section* sections = reinterpret_cast<const Section*>(base + header.directory.offset);
+    std::uint64_t expectedFirst = 0;
+    for (size_t i = 0; i < SECTION_COUNT; ++i) {
+        const Section& section = sections[i];
+        if (section.firstEntry != expectedFirst || section.entryCount > header.entryCount - expectedFirst ||
+            section.dictionaryOffset % ALIGNMENT != 0 || section.dictionaryOffset > header.dictionary.size ||
+            section.dictionarySize > header.dictionary.size - section.dictionaryOffset) {
+            throw fail("section directory is inconsistent");
+        }
+        FrontCodedDictionary keys;
+        try {
+            keys = sectionDictionary(base, header, section);
+        } catch (const std::runtime_error& error) {
+            throw fail(error.what());
+        }
+        if (keys.size() != section.entryCount) {
+            throw fail("dictionary of section " + std::to_string(i) + " does not match its entries");
+        }
+        expectedFirst += sections[i].entryCount;
+    }
+    if (expectedFirst != header.entryCount) {
+        throw fail("section directory does not cover every entry");
+    }
+    if (level == Verify::Layout) {
+        return header;
+    }
+
+    struct Check {
+        const Extent& extent;
+        std::uint64_t expected;
+        const char* name;
+    };
+    const Check checks[] = {{header.filename, header.filenameChecksum, "filename"},
+                            {header.entries, header.entriesChecksum, "entry table"},
+                            {header.dictionary, header.dictionaryChecksum, "dictionary"},
+                            {header.strings, header.stringsChecksum, "strings"},
+                            {header.postings, header.postingsChecksum, "postings"},
+                            {header.positions, header.positionsChecksum, "positions"}};
+    for (const Check& check : checks) {
+        if (checksum(base + check.extent.offset, check.extent.size) != check.expected) {
+            throw fail(std::string(check.name) + " checksum mismatch");
+        }
+    }
+
+    // Entry references must stay inside their regions
+    const Entry* entries = reinterpret_cast<const Entry*>(base + header.entries.offset);
+    for (std::uint64_t i = 0; i < header.entryCount; ++i) {
+        if (!entryInBounds(header, entries[i])) {
+            throw fail("entry " + std::to_string(i) + " refers outside its region");
+        }
+    }
+    return header;
+}
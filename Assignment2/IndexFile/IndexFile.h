@@ -0,0 +1,158 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// On-disk index format shared by Indexer::save / load
+//
+
+#ifndef INDEX_FILE_H
+#define INDEX_FILE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "../FrontCodedDictionary/FrontCodedDictionary.h"
+
+/**
+ * @class IndexFile
+ * @brief Record layouts and checks for a saved index.
+ *
+ * Layout of a saved index (all integers little-endian, every region 8-byte aligned,
+ * every reference an offset from the start of the file, never a pointer):
+ *
+ *   header            fixed size, see Header
+ *   filename          name of the indexed file
+ *   section directory SECTION_COUNT x Section (entry ranges, in section order)
+ *   entry table       entryCount x Entry, sorted by key within each section
+ *   dictionary        one FrontCodedDictionary of keys per section, aligned;
+ *                     entry firstEntry + n of a section has its key n
+ *   strings blob      display tokens that differ from their key, and surface forms
+ *   postings blob     line numbers, lineWidth bytes each, per entry in entry order
+ *   positions blob    varint positions of positional indexes
+ *
+ * Each blob is covered by a checksum and the header by its own, so a truncated
+ * or damaged file is rejected instead of producing a wrong index.
+ */
+class IndexFile {
+public:
+    static constexpr std::array<char, 8> MAGIC = {'C', '5', '4', '2', '1', 'I', 'D', 'X'};
+    static constexpr std::uint32_t VERSION = 2;  // 2: keys moved into front-coded section dictionaries
+    static constexpr size_t SECTION_COUNT = 27;
+    static constexpr size_t ALIGNMENT = 8;
+
+    // Header flags
+    static constexpr std::uint32_t FLAG_POSITIONAL = 1u << 0;
+    static constexpr std::uint32_t FLAG_CASE_INSENSITIVE = 1u << 1;
+
+    // A region of the file
+    struct Extent {
+        std::uint64_t offset = 0;
+        std::uint64_t size = 0;  // bytes
+    };
+
+    struct Header {
+        std::array<char, 8> magic = MAGIC;
+        std::uint32_t version = VERSION;
+        std::uint32_t lineWidth = 0;  // sizeof(line_type) of the index that wrote the file
+        std::uint32_t flags = 0;
+        std::uint32_t reserved = 0;
+        std::uint64_t lineCount = 0;
+        std::uint64_t tokenCount = 0;
+        std::uint64_t entryCount = 0;
+        std::uint64_t fileSize = 0;
+        Extent filename;
+        Extent directory;
+        Extent entries;
+        Extent dictionary;
+        Extent strings;
+        Extent postings;
+        Extent positions;
+        std::uint64_t filenameChecksum = 0;
+        std::uint64_t directoryChecksum = 0;
+        std::uint64_t entriesChecksum = 0;
+        std::uint64_t dictionaryChecksum = 0;
+        std::uint64_t stringsChecksum = 0;
+        std::uint64_t postingsChecksum = 0;
+        std::uint64_t positionsChecksum = 0;
+        std::uint64_t headerChecksum = 0;  // over every byte above this field
+    };
+
+    // Entries [firstEntry, firstEntry + entryCount) belong to one section; their keys
+    // are the section's dictionary, an offset into the dictionary region
+    struct Section {
+        std::uint64_t firstEntry = 0;
+        std::uint64_t entryCount = 0;
+        std::uint64_t dictionaryOffset = 0;
+        std::uint64_t dictionarySize = 0;
+    };
+
+    struct Entry {
+        std::uint64_t stringsOffset = 0;   // token bytes (if any), then each form
+        std::uint32_t tokenLength = 0;     // 0: the token is the key
+        std::uint32_t keyLength = 0;       // length of the entry's key in the dictionary
+        std::uint32_t formCount = 0;       // forms are stored as u32 length + bytes
+        std::uint32_t lastPosition = 0;
+        std::uint64_t postingsOffset = 0;  // index of the first line number in the postings blob
+        std::uint64_t postingsCount = 0;
+        std::uint64_t positionsOffset = 0; // byte offset into the positions blob
+        std::uint64_t positionsSize = 0;
+    };
+
+    /**
+     * @brief Incremental 64-bit checksum (word at a time multiply / rotate mix).
+     * Feeding a range in pieces gives the same value as feeding it at once.
+     */
+    class Checksum {
+    private:
+        std::uint64_t hash = 0x9E3779B97F4A7C15ull;
+        std::uint64_t length = 0;
+        unsigned char pending[8] = {};  // Bytes of an unfinished word
+        size_t pendingSize = 0;
+
+        void mix(std::uint64_t word);
+
+    public:
+        void update(const void* data, size_t size);
+        std::uint64_t value() const;
+    };
+
+    /**
+     * @brief Checksum of one byte range
+     */
+    static std::uint64_t checksum(const void* data, size_t size);
+
+    /**
+     * @brief size rounded up to the next multiple of ALIGNMENT
+     */
+    static constexpr std::uint64_t aligned(std::uint64_t size) {
+        return (size + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    // How much of a file validate() examines
+    enum class Verify {
+        Layout,  // header, region extents and section directory: constant time
+        Full     // also every region checksum and every entry's references
+    };
+
+    /**
+     * @brief Checks a complete file image; throws std::runtime_error naming the first problem
+     */
+    static const Header& validate(const void* data, size_t size, const std::string& path,
+                                  Verify level = Verify::Full);
+
+    /**
+     * @brief Whether an entry's strings, postings and positions lie inside their regions
+     * (for readers that skip the full check and test entries as they use them)
+     */
+    static bool entryInBounds(const Header& header, const Entry& entry);
+
+    /**
+     * @brief The key dictionary of a section, viewed in place in a validated file image
+     */
+    static FrontCodedDictionary sectionDictionary(const void* data, const Header& header, const Section& section);
+};
+
+static_assert(sizeof(IndexFile::Header) % IndexFile::ALIGNMENT == 0, "header must keep the regions aligned");
+static_assert(sizeof(IndexFile::Section) == 32 && sizeof(IndexFile::Entry) == 56,
+              "on-disk records must not depend on padding");
+
+#endif // INDEX_FILE_H
@@ -4,88 +4,458 @@
 
 
 #include "IndexedToken.h"
+#include "../ByteCoding/ByteCoding.h"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+    size_t decimalDigits(std::uint64_t value) {
+        size_t digits = 1;
+        while (value >= 10) {
+            value /= 10;
+            ++digits;
+        }
+        return digits;
+    }
+
+} // namespace
 
 // Parameterized constructor from const char*
-IndexedToken::IndexedToken(const char* text, int lineNumber)
+template <typename LineT>
+BasicIndexedToken<LineT>::BasicIndexedToken(const char* text, line_type lineNumber)
     : token(text) {  // std::string
-    intlist.push_back(lineNumber);  // std::vector
+    appendLineNumber(lineNumber);
 }
 
 // Parameterized constructor from std::string
-IndexedToken::IndexedToken(const std::string& tokenText, int lineNumber)
+template <typename LineT>
+BasicIndexedToken<LineT>::BasicIndexedToken(const std::string& tokenText, line_type lineNumber)
     : token(tokenText) {
-    intlist.push_back(lineNumber);
+    appendLineNumber(lineNumber);
+}
+
+// Positional constructor
+template <typename LineT>
+BasicIndexedToken<LineT>::BasicIndexedToken(const char* text, line_type lineNumber, position_type position)
+    : token(text) {
+    appendLineNumber(lineNumber, position);
 }
 
 // Append a line number to the intlist vector
-void IndexedToken::appendLineNumber(int lineNumber) {
+template <typename LineT>
+void BasicIndexedToken<LineT>::appendLineNumber(line_type lineNumber) {
+    // Every SKIP_INTERVAL-th posting starts a new block
+    if (intlist.size() % SKIP_INTERVAL == 0) {
+        skips.push_back(lineNumber);
+    }
     intlist.push_back(lineNumber);  // std::vector automatically manages resizing
 }
 
+// Append a line number and its position as a gap-encoded varint
+template <typename LineT>
+void BasicIndexedToken<LineT>::appendLineNumber(line_type lineNumber, position_type position) {
+    // Positions restart on every new line; within a line they only grow
+    bool sameLine = !intlist.empty() && intlist.back() == lineNumber;
+    if (sameLine && position < lastPosition) {
+        throw std::invalid_argument("token positions must not decrease within a line");
+    }
+    position_type value = sameLine ? position - lastPosition : position;
+    appendLineNumber(lineNumber);
+    lastPosition = position;
+    appendVarint(positions, value);
+}
+
+template <typename LineT>
+void BasicIndexedToken<LineT>::rebuildSkips(size_t fromBlock) {
+    skips.resize(std::min(skips.size(), fromBlock));
+    for (size_t i = skips.size() * SKIP_INTERVAL; i < intlist.size(); i += SKIP_INTERVAL) {
+        skips.push_back(intlist[i]);
+    }
+}
+
+// The byte before a varint is the last byte of the previous one: continuation bit clear
+template <typename LineT>
+size_t BasicIndexedToken<LineT>::varintStart(size_t end) const {
+    size_t start = end - 1;
+    while (start > 0 && (positions[start - 1] & 0x80)) {
+        --start;
+    }
+    return start;
+}
+
+template <typename LineT>
+void BasicIndexedToken<LineT>::insertLineNumber(line_type lineNumber) {
+    if (intlist.empty() || lineNumber >= intlist.back()) {
+        appendLineNumber(lineNumber);
+        return;
+    }
+    if (!positions.empty()) {
+        throw std::logic_error("insertLineNumber: a positional entry needs the position as well");
+    }
+    size_t at = static_cast<size_t>(std::upper_bound(intlist.begin(), intlist.end(), lineNumber) - intlist.begin());
+    intlist.insert(intlist.begin() + static_cast<std::ptrdiff_t>(at), lineNumber);
+    rebuildSkips(at / SKIP_INTERVAL);
+}
+
+// Only the postings of the target line are re-encoded: the first position of a line
+// is stored whole, so nothing on the other lines depends on them
+template <typename LineT>
+void BasicIndexedToken<LineT>::insertLineNumber(line_type lineNumber, position_type position) {
+    if (intlist.empty() || lineNumber > intlist.back() || (lineNumber == intlist.back() && position >= lastPosition)) {
+        appendLineNumber(lineNumber, position);
+        return;
+    }
+    // Postings [first, last) are on lineNumber; their varints are bytes [begin, end)
+    size_t last = static_cast<size_t>(std::upper_bound(intlist.begin(), intlist.end(), lineNumber) - intlist.begin());
+    size_t first = static_cast<size_t>(
+        std::lower_bound(intlist.begin(), intlist.begin() + static_cast<std::ptrdiff_t>(last), lineNumber) -
+        intlist.begin());
+    size_t end = positions.size();
+    for (size_t i = intlist.size(); i > last; --i) {
+        end = varintStart(end);
+    }
+    size_t begin = end;
+    for (size_t i = last; i > first; --i) {
+        begin = varintStart(begin);
+    }
+
+    // Absolute positions of the line, with the new one in order
+    std::vector<position_type> line;
+    for (size_t offset = begin; offset < end;) {
+        std::uint64_t value = 0;
+        if (!readVarint(positions.data(), end, offset, value)) {
+            throw std::runtime_error("insertLineNumber: truncated position varint");
+        }
+        line.push_back(static_cast<position_type>(line.empty() ? value : line.back() + value));
+    }
+    line.insert(std::upper_bound(line.begin(), line.end(), position), position);
+
+    std::vector<std::uint8_t> encoded;
+    position_type previous = 0;
+    for (auto it = line.cbegin(); it != line.cend(); ++it) {
+        appendVarint(encoded, *it - previous);
+        previous = *it;
+    }
+    bool atEnd = last == intlist.size();
+    positions.erase(positions.begin() + static_cast<std::ptrdiff_t>(begin),
+                    positions.begin() + static_cast<std::ptrdiff_t>(end));
+    positions.insert(positions.begin() + static_cast<std::ptrdiff_t>(begin), encoded.cbegin(), encoded.cend());
+    intlist.insert(intlist.begin() + static_cast<std::ptrdiff_t>(last), lineNumber);
+    rebuildSkips(last / SKIP_INTERVAL);
+    if (atEnd) {
+        lastPosition = line.back();
+    }
+}
+
+template <typename LineT>
+BasicIndexedToken<LineT> BasicIndexedToken<LineT>::restore(std::string token, std::string key,
+                                                           std::vector<std::string> surfaceForms,
+                                                           std::vector<line_type> lines,
+                                                           std::vector<std::uint8_t> positions,
+                                                           position_type lastPosition) {
+    BasicIndexedToken entry;
+    entry.token = std::move(token);
+    entry.key = std::move(key);
+    entry.surfaceForms = std::move(surfaceForms);
+    entry.intlist = std::move(lines);
+    entry.positions = std::move(positions);
+    entry.lastPosition = lastPosition;
+    entry.skips.reserve((entry.intlist.size() + SKIP_INTERVAL - 1) / SKIP_INTERVAL);
+    for (size_t i = 0; i < entry.intlist.size(); i += SKIP_INTERVAL) {
+        entry.skips.push_back(entry.intlist[i]);
+    }
+    return entry;
+}
+
+template <typename LineT>
+BasicIndexedToken<LineT> BasicIndexedToken<LineT>::withLineOffset(line_type lineOffset) const {
+    BasicIndexedToken entry;
+    entry.token = token;
+    entry.key = key;
+    entry.appendPostings(*this, lineOffset);
+    return entry;
+}
+
+// A line's first position is stored whole, so the other entry's positions can be
+// copied as they are once its lines follow this entry's
+template <typename LineT>
+void BasicIndexedToken<LineT>::appendPostings(const BasicIndexedToken& other, line_type lineOffset) {
+    if (other.intlist.empty()) return;
+    if (other.intlist.back() > std::numeric_limits<line_type>::max() - lineOffset) {
+        throw std::overflow_error("appendPostings: shifted line number exceeds the posting width");
+    }
+    if (!intlist.empty() && other.intlist.front() + lineOffset <= intlist.back()) {
+        throw std::invalid_argument("appendPostings: appended lines must follow the existing ones");
+    }
+    intlist.reserve(intlist.size() + other.intlist.size());
+    for (auto it = other.intlist.cbegin(); it != other.intlist.cend(); ++it) {
+        appendLineNumber(*it + lineOffset);
+    }
+    positions.insert(positions.end(), other.positions.cbegin(), other.positions.cend());
+    lastPosition = other.lastPosition;
+
+    // Spellings in order of first appearance, as if the lines had been indexed here
+    if (other.token != token) {
+        addSurfaceForm(other.token.c_str());
+    }
+    for (auto it = other.surfaceForms.cbegin(); it != other.surfaceForms.cend(); ++it) {
+        addSurfaceForm(it->c_str());
+    }
+}
+
+template <typename LineT>
+bool BasicIndexedToken<LineT>::hasPositions() const {
+    return !positions.empty();
+}
+
+template <typename LineT>
+typename BasicIndexedToken<LineT>::PositionCursor BasicIndexedToken<LineT>::positionCursor() const {
+    return PositionCursor(*this);
+}
+
+// PositionCursor - walks intlist and the varint stream in lockstep
+template <typename LineT>
+BasicIndexedToken<LineT>::PositionCursor::PositionCursor(const BasicIndexedToken& token) : owner(&token) {
+    if (valid()) decode();
+}
+
+template <typename LineT>
+bool BasicIndexedToken<LineT>::PositionCursor::valid() const {
+    // A plain (non-positional) entry has no positions to walk
+    return posting < owner->intlist.size() && !owner->positions.empty();
+}
+
+template <typename LineT>
+LineT BasicIndexedToken<LineT>::PositionCursor::line() const {
+    return owner->intlist[posting];
+}
+
+template <typename LineT>
+typename BasicIndexedToken<LineT>::position_type BasicIndexedToken<LineT>::PositionCursor::position() const {
+    return current;
+}
+
+template <typename LineT>
+void BasicIndexedToken<LineT>::PositionCursor::next() {
+    ++posting;
+    if (valid()) decode();
+}
+
+// Decodes the varint at offset; gaps are relative to the previous posting on the same line
+template <typename LineT>
+void BasicIndexedToken<LineT>::PositionCursor::decode() {
+    std::uint64_t value = 0;
+    if (!readVarint(owner->positions.data(), owner->positions.size(), offset, value)) {
+        throw std::runtime_error("PositionCursor: truncated position varint");
+    }
+
+    bool sameLine = posting > 0 && owner->intlist[posting - 1] == owner->intlist[posting];
+    current = static_cast<position_type>(sameLine ? current + value : value);
+}
+
 // Getters
-const std::string& IndexedToken::getToken() const {
+template <typename LineT>
+const std::string& BasicIndexedToken<LineT>::getToken() const {
     return token;
 }
 
-const std::vector<int>& IndexedToken::getLineNumbers() const {
+template <typename LineT>
+const std::string& BasicIndexedToken<LineT>::getKey() const {
+    return key.empty() ? token : key;
+}
+
+template <typename LineT>
+const std::vector<std::uint8_t>& BasicIndexedToken<LineT>::getPositions() const {
+    return positions;
+}
+
+template <typename LineT>
+typename BasicIndexedToken<LineT>::position_type BasicIndexedToken<LineT>::getLastPosition() const {
+    return lastPosition;
+}
+
+template <typename LineT>
+const std::vector<std::string>& BasicIndexedToken<LineT>::getSurfaceForms() const {
+    return surfaceForms;
+}
+
+// Only stored when folding changed the text
+template <typename LineT>
+void BasicIndexedToken<LineT>::setKey(const std::string& foldedKey) {
+    if (foldedKey != token) {
+        key = foldedKey;
+    } else {
+        key.clear();
+    }
+}
+
+template <typename LineT>
+void BasicIndexedToken<LineT>::addSurfaceForm(const char* text) {
+    if (token == text) return;
+    if (std::find(surfaceForms.cbegin(), surfaceForms.cend(), text) == surfaceForms.cend()) {
+        surfaceForms.emplace_back(text);
+    }
+}
+
+template <typename LineT>
+const std::vector<LineT>& BasicIndexedToken<LineT>::getLineNumbers() const {
     return intlist;
 }
 
+// Position of the first posting >= lineNumber
+template <typename LineT>
+size_t BasicIndexedToken<LineT>::lowerBound(line_type lineNumber) const {
+    if (intlist.empty() || lineNumber <= intlist.front()) return 0;
+    if (lineNumber > intlist.back()) return intlist.size();
+
+    // The last block starting strictly below lineNumber holds the answer
+    // (or it is the first posting of the following block)
+    auto skip = std::lower_bound(skips.cbegin(), skips.cend(), lineNumber);
+    size_t block = static_cast<size_t>(skip - skips.cbegin()) - 1;
+    auto first = intlist.cbegin() + block * SKIP_INTERVAL;
+    auto last = intlist.cend() - first > static_cast<std::ptrdiff_t>(SKIP_INTERVAL)
+                    ? first + SKIP_INTERVAL : intlist.cend();
+    while (first != last && *first < lineNumber) {
+        ++first;
+    }
+    return static_cast<size_t>(first - intlist.cbegin());
+}
+
+// Postings within [lo, hi]
+template <typename LineT>
+std::span<const LineT> BasicIndexedToken<LineT>::linesInRange(line_type lo, line_type hi) const {
+    if (lo > hi || intlist.empty() || hi < intlist.front() || lo > intlist.back()) {
+        return {};
+    }
+    size_t first = lowerBound(lo);
+    // hi at or past the last posting (hi + 1 would wrap at the type's maximum)
+    size_t last = hi >= intlist.back() ? intlist.size() : lowerBound(hi + 1);
+    return std::span<const line_type>(intlist.data() + first, last - first);
+}
+
 // Get the length of the token text
-size_t IndexedToken::length() const {
+template <typename LineT>
+size_t BasicIndexedToken<LineT>::length() const {
     return token.length();
 }
 
 // Get the token text as const char*
-const char* IndexedToken::c_str() const {
+template <typename LineT>
+const char* BasicIndexedToken<LineT>::c_str() const {
     return token.c_str();
 }
 
 // Print function
-void IndexedToken::print(std::ostream& os) const {
-    os << token << " ";
+template <typename LineT>
+void BasicIndexedToken<LineT>::print(std::ostream& os) const {
+    // Rendered in one piece; the stream is not flushed, as before
+    std::string text;
+    BufferedWriter out(text);
+    print(out);
+    os.write(text.data(), static_cast<std::streamsize>(text.size()));
+}
 
-    // Use iterators to traverse the vector
-    for (auto it = intlist.cbegin(); it != intlist.cend(); ++it) {
-        if (it != intlist.cbegin()) {
-            os << " ";
+template <typename LineT>
+void BasicIndexedToken<LineT>::print(BufferedWriter& out) const {
+    out << token;
+    if (!surfaceForms.empty()) {
+        out << " (";
+        for (auto it = surfaceForms.cbegin(); it != surfaceForms.cend(); ++it) {
+            if (it != surfaceForms.cbegin()) {
+                out << ", ";
+            }
+            out << *it;
         }
-        os << *it;
+        out << ')';
     }
+    out << ' ';
+
+    // The whole postings list in one call
+    out.writeNumbers(std::span<const LineT>(intlist));
 }
 
 // Compare functions
-int IndexedToken::compare(const char* other) const {
-    return token.compare(other);  // std::string comparison
+template <typename LineT>
+int BasicIndexedToken<LineT>::compare(const char* other) const {
+    return getKey().compare(other);  // std::string comparison
 }
 
-int IndexedToken::compare(const std::string& other) const {
-    return token.compare(other);
+template <typename LineT>
+int BasicIndexedToken<LineT>::compare(const std::string& other) const {
+    return getKey().compare(other);
 }
 
-int IndexedToken::compare(const IndexedToken& other) const {
-    return token.compare(other.token);
+template <typename LineT>
+int BasicIndexedToken<LineT>::compare(const BasicIndexedToken& other) const {
+    return getKey().compare(other.getKey());
 }
 
 // Convenience operators for comparison
-bool IndexedToken::operator<(const IndexedToken& other) const {
-    return token < other.token;  // std::string provides lexicographical comparison
+template <typename LineT>
+bool BasicIndexedToken<LineT>::operator<(const BasicIndexedToken& other) const {
+    return getKey() < other.getKey();  // std::string provides lexicographical comparison
 }
 
-bool IndexedToken::operator>(const IndexedToken& other) const {
-    return token > other.token;
+template <typename LineT>
+bool BasicIndexedToken<LineT>::operator>(const BasicIndexedToken& other) const {
+    return getKey() > other.getKey();
 }
 
-bool IndexedToken::operator==(const IndexedToken& other) const {
-    return token == other.token;
+template <typename LineT>
+bool BasicIndexedToken<LineT>::operator==(const BasicIndexedToken& other) const {
+    return getKey() == other.getKey();
 }
 
-bool IndexedToken::operator!=(const IndexedToken& other) const {
-    return token != other.token;
+template <typename LineT>
+bool BasicIndexedToken<LineT>::operator!=(const BasicIndexedToken& other) const {
+    return getKey() != other.getKey();
 }
 
 // Stream output operator
-std::ostream& operator<<(std::ostream& os, const IndexedToken& indexedToken) {
+template <typename LineT>
+std::ostream& operator<<(std::ostream& os, const BasicIndexedToken<LineT>& indexedToken) {
     indexedToken.print(os);
     return os;
-}
\ No newline at end of file
+}
+
+template <typename LineT>
+void formatTokens(std::span<const BasicIndexedToken<LineT>* const> tokens, BufferedWriter& out) {
+    // Upper bound: every posting is as wide as the last (largest) line number
+    size_t bytes = 0;
+    for (const BasicIndexedToken<LineT>* entry : tokens) {
+        bytes += entry->getToken().size() + 2;
+        for (auto it = entry->getSurfaceForms().cbegin(); it != entry->getSurfaceForms().cend(); ++it) {
+            bytes += it->size() + 4;
+        }
+        const std::vector<LineT>& lines = entry->getLineNumbers();
+        if (!lines.empty()) {
+            bytes += lines.size() * (decimalDigits(lines.back()) + 1);
+        }
+    }
+    out.reserve(std::min(bytes, BufferedWriter::DEFAULT_CAPACITY));
+
+    for (const BasicIndexedToken<LineT>* entry : tokens) {
+        entry->print(out);
+        out.put('\n');
+    }
+}
+
+template <typename LineT>
+std::string formatTokens(std::span<const BasicIndexedToken<LineT>* const> tokens) {
+    std::string text;
+    BufferedWriter out(text);
+    formatTokens(tokens, out);
+    return text;
+}
+
+// Explicit instantiations for the two supported posting widths
+template class BasicIndexedToken<std::uint32_t>;
+template class BasicIndexedToken<std::uint64_t>;
+template std::ostream& operator<<(std::ostream&, const BasicIndexedToken<std::uint32_t>&);
+template std::ostream& operator<<(std::ostream&, const BasicIndexedToken<std::uint64_t>&);
+template void formatTokens(std::span<const BasicIndexedToken<std::uint32_t>* const>, BufferedWriter&);
+template void formatTokens(std::span<const BasicIndexedToken<std::uint64_t>* const>, BufferedWriter&);
+template std::string formatTokens(std::span<const BasicIndexedToken<std::uint32_t>* const>);
+template std::string formatTokens(std::span<const BasicIndexedToken<std::uint64_t>* const>);
@@ -5,47 +5,156 @@
 #ifndef INDEXED_TOKEN_H
 #define INDEXED_TOKEN_H
 
+#include <cstdint>
+#include <span>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include <iostream>
+#include "../BufferedWriter/BufferedWriter.h"
 
 /**
- * IndexedToken Class
- * @brief Aggregates a token (as std::string) and its list of line numbers (as std::vector<int>),
+ * BasicIndexedToken Class
+ * @brief Aggregates a token (as std::string) and its list of line numbers (as std::vector<LineT>),
  * representing a complete index entry for the token.
+ *
+ * LineT is the posting width: std::uint32_t keeps postings compact for normal files,
+ * std::uint64_t is used for inputs with more than 2^32 - 1 lines.
  */
-class IndexedToken {
+template <typename LineT>
+class BasicIndexedToken {
+    static_assert(std::is_unsigned_v<LineT>, "line numbers must be an unsigned integer type");
+
+public:
+    using line_type = LineT;
+    using position_type = std::uint32_t;  // Ordinal of a token within its line
+
+    // Number of postings covered by one skip entry
+    static constexpr size_t SKIP_INTERVAL = 64;
+
 private:
-    std::string token;           // The token as std::string (replaces Token class)
-    std::vector<int> intlist;    // The list of line numbers as std::vector<int> (replaces IntList class)
+    std::string token;              // The token as std::string (replaces Token class)
+    std::string key;                // Sort / match key when it differs from token (case folding)
+    std::vector<std::string> surfaceForms;  // Other spellings merged under the same key
+    std::vector<line_type> intlist; // The list of line numbers (replaces IntList class)
+    std::vector<line_type> skips;   // First line number of every SKIP_INTERVAL block of intlist
+    // Positional postings only: one varint per line number, parallel to intlist.
+    // A position is stored as the gap from the previous position on the same line.
+    std::vector<std::uint8_t> positions;
+    position_type lastPosition = 0;  // Last position appended (for gap encoding)
+
+    BasicIndexedToken() = default;  // for restore()
+
+    // Recompute the skip entries from block fromBlock onwards
+    void rebuildSkips(size_t fromBlock);
+    // Start of the position varint that ends just before byte end
+    size_t varintStart(size_t end) const;
+
+public:
+    /**
+     * @brief Forward cursor over (line, position) pairs of a positional token
+     */
+    class PositionCursor {
+    private:
+        const BasicIndexedToken* owner;
+        size_t posting = 0;        // Index into intlist
+        size_t offset = 0;         // Byte offset into positions
+        position_type current = 0; // Decoded position of the current posting
+
+        void decode();
+
+    public:
+        explicit PositionCursor(const BasicIndexedToken& token);
+        bool valid() const;
+        line_type line() const;
+        position_type position() const;
+        void next();
+    };
 
 public:
     // Parameterized constructors
-    IndexedToken(const char* text, int lineNumber);
-    IndexedToken(const std::string& tokenText, int lineNumber);
+    BasicIndexedToken(const char* text, line_type lineNumber);
+    BasicIndexedToken(const std::string& tokenText, line_type lineNumber);
+    // Positional entry: records where on the line the token occurred
+    BasicIndexedToken(const char* text, line_type lineNumber, position_type position);
     // Rule of Five functions :
 
     // Copy constructor
-    IndexedToken(const IndexedToken& other) = default;
+    BasicIndexedToken(const BasicIndexedToken& other) = default;
 
     // Move constructor
-    IndexedToken(IndexedToken&& other) noexcept = default;
+    BasicIndexedToken(BasicIndexedToken&& other) noexcept = default;
 
     // Copy assignment operator
-    IndexedToken& operator=(const IndexedToken& other) = default;
+    BasicIndexedToken& operator=(const BasicIndexedToken& other) = default;
 
     // Move assignment operator
-    IndexedToken& operator=(IndexedToken&& other) noexcept = default;
+    BasicIndexedToken& operator=(BasicIndexedToken&& other) noexcept = default;
 
     // Destructor
-    ~IndexedToken() = default;
+    ~BasicIndexedToken() = default;
 
     // Append a line number to the intlist vector
-    void appendLineNumber(int lineNumber);
+    void appendLineNumber(line_type lineNumber);
+    // Append a line number with the token's position on that line (positional entries)
+    void appendLineNumber(line_type lineNumber, position_type position);
+    // Out-of-order forms for producers that do not deliver lines in order: the posting
+    // goes to its sorted place. Appending is the fast path; otherwise the postings after
+    // the insertion point are moved, so inserts close to the end stay cheap.
+    void insertLineNumber(line_type lineNumber);
+    void insertLineNumber(line_type lineNumber, position_type position);
+
+    // True if the entry stores positions alongside its line numbers
+    bool hasPositions() const;
+
+    // Cursor over the decoded (line, position) pairs, in posting order
+    PositionCursor positionCursor() const;
 
     // Getters
     const std::string& getToken() const;
-    const std::vector<int>& getLineNumbers() const;
+    // Key used for ordering and matching; the token itself unless the index folds case
+    const std::string& getKey() const;
+    const std::vector<std::string>& getSurfaceForms() const;
+
+    // Set the folded key; must be done before the entry is placed in an index
+    void setKey(const std::string& foldedKey);
+    // Record another spelling of this key (kept for display, duplicates ignored)
+    void addSurfaceForm(const char* text);
+    const std::vector<line_type>& getLineNumbers() const;
+    // Encoded positions (empty unless positional) and the last position appended
+    const std::vector<std::uint8_t>& getPositions() const;
+    position_type getLastPosition() const;
+
+    /**
+     * @brief Rebuild an entry from saved parts (see Indexer::load). key is empty when
+     * it equals the token; the skip entries are recomputed from lines.
+     */
+    static BasicIndexedToken restore(std::string token, std::string key, std::vector<std::string> surfaceForms,
+                                     std::vector<line_type> lines, std::vector<std::uint8_t> positions,
+                                     position_type lastPosition);
+
+    /**
+     * @brief Copy of the entry with lineOffset added to every line number
+     */
+    BasicIndexedToken withLineOffset(line_type lineOffset) const;
+
+    /**
+     * @brief Append another entry's postings (and positions and spellings), its line
+     * numbers shifted by lineOffset. The shifted lines must all come after this entry's.
+     * Throws std::invalid_argument if they do not, std::overflow_error if a line wraps.
+     */
+    void appendPostings(const BasicIndexedToken& other, line_type lineOffset);
+
+    /**
+     * @brief Position of the first posting >= lineNumber; binary search on the
+     * skip entries followed by a scan of a single block
+     */
+    size_t lowerBound(line_type lineNumber) const;
+
+    /**
+     * @brief Postings that fall within [lo, hi], as a view into the intlist vector
+     */
+    std::span<const line_type> linesInRange(line_type lo, line_type hi) const;
 
     /**
      * @brief Get the length of the token text
@@ -57,22 +166,42 @@ public:
      */
     const char* c_str() const;
 
-    // Print function
+    // Print function - other surface forms, if any, follow the token in parentheses
     void print(std::ostream& os = std::cout) const;
+    void print(BufferedWriter& out) const;
 
-    // Compare functions
+    // Compare functions (by key)
     int compare(const char* other) const;
     int compare(const std::string& other) const;
-    int compare(const IndexedToken& other) const;
+    int compare(const BasicIndexedToken& other) const;
 
     // Convenience operators for comparison
-    bool operator<(const IndexedToken& other) const;
-    bool operator>(const IndexedToken& other) const;
-    bool operator==(const IndexedToken& other) const;
-    bool operator!=(const IndexedToken& other) const;
-
-    // Stream output operator
-    friend std::ostream& operator<<(std::ostream& os, const IndexedToken& indexedToken);
+    bool operator<(const BasicIndexedToken& other) const;
+    bool operator>(const BasicIndexedToken& other) const;
+    bool operator==(const BasicIndexedToken& other) const;
+    bool operator!=(const BasicIndexedToken& other) const;
 };
 
-#endif // INDEXED_TOKEN_H
\ No newline at end of file
+// Stream output operator
+template <typename LineT>
+std::ostream& operator<<(std::ostream& os, const BasicIndexedToken<LineT>& indexedToken);
+
+/**
+ * @brief Batch formatting: every entry as print() writes it, each followed by
+ * '\n', as one contiguous block sized up front
+ */
+template <typename LineT>
+void formatTokens(std::span<const BasicIndexedToken<LineT>* const> tokens, BufferedWriter& out);
+template <typename LineT>
+std::string formatTokens(std::span<const BasicIndexedToken<LineT>* const> tokens);
+
+// Compact postings (4 bytes per line number) for normal files
+using IndexedToken = BasicIndexedToken<std::uint32_t>;
+// Wide postings (8 bytes per line number) for inputs past 2^32 - 1 lines
+using LargeIndexedToken = BasicIndexedToken<std::uint64_t>;
+
+// Both widths are instantiated once in IndexedToken.cpp
+extern template class BasicIndexedToken<std::uint32_t>;
+extern template class BasicIndexedToken<std::uint64_t>;
+
+#endif // INDEXED_TOKEN_H
@@ -5,10 +5,19 @@
 
 
 #include "Indexer.h"
+#include "../ThreadPool/ThreadPool.h"
+#include <cstring>
+#include <filesystem>
 #include <fstream>
+#include <future>
 #include <sstream>
 #include <cctype>
+#include <deque>
+#include <algorithm>
 #include <iostream>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
 
 // Helper function to determine which section (0-26) a character belongs to
 int getSectionIndex(char c) {
@@ -19,41 +28,129 @@ int getSectionIndex(char c) {
     return Indexer::NUM_SECTIONS - 1;  // Non-alphabetic characters go to section 26
 }
 
+// Lower-case copy used as the key in case-insensitive mode
+std::string foldCase(std::string_view text) {
+    std::string folded(text);
+    for (char& c : folded) {
+        c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+    }
+    return folded;
+}
+
 // Default constructor - std::array and std::list are automatically initialized
-Indexer::Indexer() : currentFilename("") {
+template <typename Traits>
+BasicIndexer<Traits>::BasicIndexer() : currentFilename(""), lazy(std::make_unique<LazyState>()) {
     // STL containers handle initialization automatically via RAII
 }
 
-void Indexer::processToken(const char* text, int lineNumber) {
+// Copy constructor - copies the sections, then points fresh lookups at them
+template <typename Traits>
+BasicIndexer<Traits>::BasicIndexer(const BasicIndexer& other)
+    : index(other.index), currentFilename(other.currentFilename),
+      lineCount(other.lineCount), tokenCount(other.tokenCount), positional(other.positional),
+      caseInsensitive(other.caseInsensitive), version(other.version), lazy(std::make_unique<LazyState>()) {
+    rebuildIndexes();
+}
+
+// Copy assignment operator
+template <typename Traits>
+BasicIndexer<Traits>& BasicIndexer<Traits>::operator=(const BasicIndexer& other) {
+    if (this != &other) {
+        index = other.index;
+        currentFilename = other.currentFilename;
+        lineCount = other.lineCount;
+        tokenCount = other.tokenCount;
+        positional = other.positional;
+        caseInsensitive = other.caseInsensitive;
+        version = other.version;
+        lazy = std::make_unique<LazyState>();
+        rebuildIndexes();
+    }
+    return *this;
+}
+
+// Rebuild the lookup maps and the by-length index from the section lists;
+// every entry is pending for the fuzzy tree
+template <typename Traits>
+void BasicIndexer<Traits>::rebuildIndexes() {
+    for (size_t i = 0; i < index.size(); ++i) {
+        lookup[i].clear();
+        byLength[i].clear();
+        fuzzyPending[i].clear();
+        // Lists are already sorted, so every insert goes at the end
+        for (auto it = index[i].begin(); it != index[i].end(); ++it) {
+            lookup[i].emplace_hint(lookup[i].end(), std::string_view(it->getKey()), it);
+            byLength[i][it->length()].push_back(&*it);
+            fuzzyPending[i].push_back(&*it);
+        }
+    }
+}
+
+template <typename Traits>
+void BasicIndexer<Traits>::processToken(const char* text, line_type lineNumber) {
+    processToken(text, lineNumber, 0);
+}
+
+template <typename Traits>
+void BasicIndexer<Traits>::processToken(const char* text, line_type lineNumber, position_type position) {
     if (!text || !*text) return; // Skip empty or null tokens
+    ++version;
 
     // Determine which section this token belongs to based on first character
     int sectionIndex = getSectionIndex(text[0]);
-    std::list<IndexedToken>& targetSection = index[sectionIndex];
+    section_type& targetSection = index[sectionIndex];
+    lookup_type& targetLookup = lookup[sectionIndex];
 
-    // Use iterators to search for existing token in the sorted list
-    auto x = targetSection.begin();
-    while (x != targetSection.end() && x->compare(text) < 0) {
-        ++x;
+    // Binary search the section's lookup for the token or its sorted position
+    std::string folded;
+    std::string_view key(text);
+    if (caseInsensitive) {
+        folded = foldCase(key);
+        key = folded;
     }
+    auto x = targetLookup.lower_bound(key);
 
     // Check if token already exists at this position
-    if (x != targetSection.end() && x ->compare(text) == 0) {
+    if (x != targetLookup.end() && x->first == key) {
         // Token exists; add this line number to existing token
-        const_cast<IndexedToken&>(*x).appendLineNumber(lineNumber);
+        if (caseInsensitive) {
+            x->second->addSurfaceForm(text);
+        }
+        if (positional) {
+            x->second->appendLineNumber(lineNumber, position);
+        } else {
+            x->second->appendLineNumber(lineNumber);
+        }
     } else {
         // Token doesn't exist; create new IndexedToken and insert at sorted position
-        IndexedToken newToken(text, lineNumber);
-        targetSection.insert(x, newToken);
+        auto before = (x == targetLookup.end()) ? targetSection.end() : x->second;
+        auto inserted = positional ? targetSection.emplace(before, text, lineNumber, position)
+                                   : targetSection.emplace(before, text, lineNumber);
+        if (caseInsensitive) {
+            inserted->setKey(folded);
+        }
+        targetLookup.emplace_hint(x, std::string_view(inserted->getKey()), inserted);
+        fuzzyPending[sectionIndex].push_back(&*inserted);
+
+        // Keep the length bucket in section order as well
+        std::vector<const token_type*>& bucket = byLength[sectionIndex][inserted->length()];
+        auto slot = std::lower_bound(bucket.begin(), bucket.end(), key,
+                                     [](const token_type* entry, std::string_view k) { return entry->getKey() < k; });
+        bucket.insert(slot, &*inserted);
+        if (!lazy) {
+            lazy = std::make_unique<LazyState>();  // moved-from index being reused
+        }
     }
 }
 
 // Overloaded version that accepts std::string
-void Indexer::processToken(const std::string& token, int lineNumber) {
+template <typename Traits>
+void BasicIndexer<Traits>::processToken(const std::string& token, line_type lineNumber) {
     processToken(token.c_str(), lineNumber);
 }
 
-void Indexer::processTextFile(const std::string& filename) {
+template <typename Traits>
+void BasicIndexer<Traits>::processTextFile(const std::string& filename) {
     std::ifstream file(filename);
 
     if (!file.is_open()) {
@@ -66,35 +163,407 @@ void Indexer::processTextFile(const std::string& filename) {
     currentFilename = filename;
 
     std::string line;
-    int lineNumber = 1;
-    int totalTokens = 0;
-
     while (std::getline(file, line)) {
-        // Tokenize the line
-        std::istringstream iss(line);
-        std::string word;
-
-        // Extract words separated by whitespace
-        while (iss >> word) {
-            // Clean the word (remove punctuation, etc.)
-            std::string cleanWord = cleanToken(word);
-            if (!cleanWord.empty()) {
-                processToken(cleanWord, lineNumber);
-                totalTokens++;
+        processLine(line);
+    }
+
+    file.close();
+
+    // Print success message with line and token counts
+    std::cout << "File indexed successfully (" << lineCount
+              << " lines, " << tokenCount << " tokens processed)." << std::endl;
+}
+
+template <typename Traits>
+std::overflow_error BasicIndexer<Traits>::widthError(const std::string& counter) const {
+    std::string source = currentFilename.empty() ? "" : " for '" + currentFilename + "'";
+    return std::overflow_error(counter + " exceeds the index width; use LargeIndexer" + source);
+}
+
+template <typename Traits>
+std::vector<std::string> BasicIndexer<Traits>::tokenizeLine(const std::string& line) {
+    std::vector<std::string> tokens;
+    std::istringstream iss(line);
+    std::string word;
+
+    // Extract words separated by whitespace
+    while (iss >> word) {
+        // Clean the word (remove punctuation, etc.)
+        std::string cleanWord = cleanToken(word);
+        if (!cleanWord.empty()) {
+            tokens.push_back(std::move(cleanWord));
+        }
+    }
+    return tokens;
+}
+
+template <typename Traits>
+void BasicIndexer<Traits>::addLine(line_type lineNumber, const std::vector<std::string>& tokens) {
+    // Refuse to wrap around: a wider index (LargeIndexer) is needed for this input
+    if (lineNumber > std::numeric_limits<count_type>::max()) {
+        throw widthError("line count");
+    }
+    if (tokens.size() > std::numeric_limits<count_type>::max() - tokenCount) {
+        throw widthError("token count");
+    }
+
+    // Position counts indexed tokens on the line
+    position_type position = 0;
+    for (auto it = tokens.begin(); it != tokens.end(); ++it) {
+        processToken(it->c_str(), lineNumber, position++);
+    }
+    tokenCount += static_cast<count_type>(tokens.size());
+    if (lineNumber > lineCount) {
+        lineCount = static_cast<count_type>(lineNumber);
+    }
+}
+
+template <typename Traits>
+void BasicIndexer<Traits>::processLine(const std::string& line) {
+    if (lineCount == std::numeric_limits<line_type>::max()) {
+        throw widthError("line count");
+    }
+    addLine(static_cast<line_type>(lineCount + 1), tokenizeLine(line));
+}
+
+// Merge: one heap of section cursors per section, ordered by key and then by part,
+// so equal keys come out in part order and their postings append in line order
+template <typename Traits>
+BasicIndexer<Traits> BasicIndexer<Traits>::merged(std::span<const BasicIndexer* const> parts,
+                                                  std::span<const line_type> lineOffsets) {
+    if (parts.size() != lineOffsets.size()) {
+        throw std::invalid_argument("BasicIndexer::merged: one line offset is needed per part");
+    }
+    BasicIndexer result;
+    if (parts.empty()) {
+        return result;
+    }
+    result.positional = parts.front()->positional;
+    result.caseInsensitive = parts.front()->caseInsensitive;
+    result.currentFilename = parts.front()->currentFilename;
+
+    std::uint64_t lineEnd = 0;  // Last line covered by the parts so far
+    std::uint64_t tokens = 0;
+    for (size_t i = 0; i < parts.size(); ++i) {
+        const BasicIndexer& part = *parts[i];
+        if (part.positional != result.positional || part.caseInsensitive != result.caseInsensitive) {
+            throw std::invalid_argument("BasicIndexer::merged: parts use different positional or case modes");
+        }
+        if (part.isEmpty() && part.lineCount == 0) continue;
+        if (lineOffsets[i] < lineEnd) {
+            throw std::invalid_argument("BasicIndexer::merged: part " + std::to_string(i) +
+                                        " overlaps the lines of the parts before it");
+        }
+        lineEnd = static_cast<std::uint64_t>(lineOffsets[i]) + part.lineCount;
+        tokens += part.tokenCount;
+        if (lineEnd > std::numeric_limits<count_type>::max() || tokens > std::numeric_limits<count_type>::max()) {
+            throw std::overflow_error("BasicIndexer::merged: merged counts exceed the index width");
+        }
+    }
+    result.lineCount = static_cast<count_type>(lineEnd);
+    result.tokenCount = static_cast<count_type>(tokens);
+
+    using cursor_type = std::pair<typename section_type::const_iterator, size_t>;  // entry, part
+    auto later = [](const cursor_type& a, const cursor_type& b) {
+        int order = a.first->getKey().compare(b.first->getKey());
+        return order > 0 || (order == 0 && a.second > b.second);
+    };
+    std::vector<cursor_type> heads;
+    for (int s = 0; s < NUM_SECTIONS; ++s) {
+        heads.clear();
+        for (size_t i = 0; i < parts.size(); ++i) {
+            if (!parts[i]->index[s].empty()) {
+                heads.emplace_back(parts[i]->index[s].cbegin(), i);
+            }
+        }
+        std::make_heap(heads.begin(), heads.end(), later);
+        section_type& target = result.index[s];
+        while (!heads.empty()) {
+            std::pop_heap(heads.begin(), heads.end(), later);
+            cursor_type& head = heads.back();
+            if (!target.empty() && target.back().getKey() == head.first->getKey()) {
+                target.back().appendPostings(*head.first, lineOffsets[head.second]);
+            } else {
+                target.push_back(head.first->withLineOffset(lineOffsets[head.second]));
+            }
+            if (++head.first != parts[head.second]->index[s].cend()) {
+                std::push_heap(heads.begin(), heads.end(), later);
+            } else {
+                heads.pop_back();
+            }
+        }
+    }
+    result.rebuildIndexes();
+    return result;
+}
+
+template <typename Traits>
+void BasicIndexer<Traits>::merge(const BasicIndexer& other, line_type lineOffset) {
+    const BasicIndexer* parts[] = {this, &other};
+    const line_type offsets[] = {0, lineOffset};
+    BasicIndexer combined = merged(parts, offsets);
+    combined.version = version + 1;
+    *this = std::move(combined);
+}
+
+// Save: the directory and entry table are built first so every region's offset
+// is known, then the regions are streamed out and the header is written last
+template <typename Traits>
+void BasicIndexer<Traits>::save(const std::string& path) const {
+    IndexFile::Header header;
+    header.lineWidth = sizeof(line_type);
+    header.flags = (positional ? IndexFile::FLAG_POSITIONAL : 0) | (caseInsensitive ? IndexFile::FLAG_CASE_INSENSITIVE : 0);
+    header.lineCount = lineCount;
+    header.tokenCount = tokenCount;
+
+    std::array<IndexFile::Section, IndexFile::SECTION_COUNT> sections;
+    std::vector<IndexFile::Entry> entries;
+    std::array<std::string, IndexFile::SECTION_COUNT> dictionaries;  // encoded keys per section
+    std::uint64_t dictionarySize = 0;
+    std::uint64_t stringsSize = 0;
+    std::uint64_t postingsCount = 0;
+    std::uint64_t positionsSize = 0;
+    for (size_t i = 0; i < index.size(); ++i) {
+        sections[i].firstEntry = entries.size();
+        std::vector<std::string_view> keys;
+        keys.reserve(index[i].size());
+        for (auto it = index[i].cbegin(); it != index[i].cend(); ++it) {
+            keys.push_back(it->getKey());
+            IndexFile::Entry entry;
+            entry.stringsOffset = stringsSize;
+            entry.tokenLength = it->getKey() == it->getToken() ? 0 : static_cast<std::uint32_t>(it->getToken().size());
+            entry.keyLength = static_cast<std::uint32_t>(it->getKey().size());
+            entry.formCount = static_cast<std::uint32_t>(it->getSurfaceForms().size());
+            entry.lastPosition = it->getLastPosition();
+            entry.postingsOffset = postingsCount;
+            entry.postingsCount = it->getLineNumbers().size();
+            entry.positionsOffset = positionsSize;
+            entry.positionsSize = it->getPositions().size();
+
+            stringsSize += entry.tokenLength;
+            for (auto form = it->getSurfaceForms().cbegin(); form != it->getSurfaceForms().cend(); ++form) {
+                stringsSize += sizeof(std::uint32_t) + form->size();
             }
+            postingsCount += entry.postingsCount;
+            positionsSize += entry.positionsSize;
+            entries.push_back(entry);
         }
+        sections[i].entryCount = entries.size() - sections[i].firstEntry;
+        dictionaries[i] = FrontCodedDictionary::encode(keys);
+        sections[i].dictionaryOffset = IndexFile::aligned(dictionarySize);
+        sections[i].dictionarySize = dictionaries[i].size();
+        dictionarySize = sections[i].dictionaryOffset + sections[i].dictionarySize;
+    }
+    header.entryCount = entries.size();
+
+    // Regions follow each other, each starting on an aligned offset
+    std::uint64_t offset = IndexFile::aligned(sizeof(header));
+    auto place = [&offset](IndexFile::Extent& extent, std::uint64_t size) {
+        extent.offset = offset;
+        extent.size = size;
+        offset = IndexFile::aligned(offset + size);
+    };
+    place(header.filename, currentFilename.size());
+    place(header.directory, sizeof(sections));
+    place(header.entries, entries.size() * sizeof(IndexFile::Entry));
+    place(header.dictionary, dictionarySize);
+    place(header.strings, stringsSize);
+    place(header.postings, postingsCount * sizeof(line_type));
+    place(header.positions, positionsSize);
+    header.fileSize = header.positions.offset + header.positions.size;
 
-        lineNumber++;
+    std::string temporary = path + ".tmp";
+    std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not create index file: " + temporary);
     }
+    {
+        BufferedWriter out(file);
+        std::uint64_t written = 0;
+        auto raw = [&out, &written](const void* data, size_t size) {
+            out.write(std::string_view(static_cast<const char*>(data), size));
+            written += size;
+        };
+        auto padTo = [&](std::uint64_t target) {
+            static const char zeros[IndexFile::ALIGNMENT] = {};
+            raw(zeros, target - written);
+        };
+
+        IndexFile::Header placeholder{};
+        raw(&placeholder, sizeof(placeholder));  // rewritten once the checksums are known
+        padTo(header.filename.offset);
+        raw(currentFilename.data(), currentFilename.size());
+        header.filenameChecksum = IndexFile::checksum(currentFilename.data(), currentFilename.size());
+        padTo(header.directory.offset);
+        raw(sections.data(), sizeof(sections));
+        header.directoryChecksum = IndexFile::checksum(sections.data(), sizeof(sections));
+        padTo(header.entries.offset);
+        raw(entries.data(), entries.size() * sizeof(IndexFile::Entry));
+        header.entriesChecksum = IndexFile::checksum(entries.data(), entries.size() * sizeof(IndexFile::Entry));
+
+        // The blobs are streamed from the entries, checksummed on the way out
+        IndexFile::Checksum sum;
+        auto blob = [&](const void* data, size_t size) {
+            raw(data, size);
+            sum.update(data, size);
+        };
+        padTo(header.dictionary.offset);
+        for (size_t i = 0; i < dictionaries.size(); ++i) {
+            static const char zeros[IndexFile::ALIGNMENT] = {};
+            blob(zeros, header.dictionary.offset + sections[i].dictionaryOffset - written);
+            blob(dictionaries[i].data(), dictionaries[i].size());
+        }
+        header.dictionaryChecksum = sum.value();
+
+        sum = IndexFile::Checksum();
+        padTo(header.strings.offset);
+        for (auto section = index.cbegin(); section != index.cend(); ++section) {
+            for (auto it = section->cbegin(); it != section->cend(); ++it) {
+                if (it->getKey() != it->getToken()) {
+                    blob(it->getToken().data(), it->getToken().size());
+                }
+                for (auto form = it->getSurfaceForms().cbegin(); form != it->getSurfaceForms().cend(); ++form) {
+                    std::uint32_t length = static_cast<std::uint32_t>(form->size());
+                    blob(&length, sizeof(length));
+                    blob(form->data(), form->size());
+                }
+            }
+        }
+        header.stringsChecksum = sum.value();
 
+        sum = IndexFile::Checksum();
+        padTo(header.postings.offset);
+        for (auto section = index.cbegin(); section != index.cend(); ++section) {
+            for (auto it = section->cbegin(); it != section->cend(); ++it) {
+                blob(it->getLineNumbers().data(), it->getLineNumbers().size() * sizeof(line_type));
+            }
+        }
+        header.postingsChecksum = sum.value();
+
+        sum = IndexFile::Checksum();
+        padTo(header.positions.offset);
+        for (auto section = index.cbegin(); section != index.cend(); ++section) {
+            for (auto it = section->cbegin(); it != section->cend(); ++it) {
+                blob(it->getPositions().data(), it->getPositions().size());
+            }
+        }
+        header.positionsChecksum = sum.value();
+        out.flush();
+    }
+
+    header.headerChecksum = IndexFile::checksum(&header, offsetof(IndexFile::Header, headerChecksum));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
     file.close();
+    if (!file) {
+        throw std::runtime_error("Failed writing index file: " + temporary);
+    }
+    std::filesystem::rename(temporary, path);
+}
 
-    // Print success message with line and token counts
-    std::cout << "File indexed successfully (" << (lineNumber - 1)
-              << " lines, " << totalTokens << " tokens processed)." << std::endl;
+// Load: the whole file is read into one aligned buffer and validated, then each
+// entry is rebuilt from its slices; the lookups are rebuilt at the end
+template <typename Traits>
+void BasicIndexer<Traits>::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open index file: " + path);
+    }
+    std::streamoff size = file.tellg();
+    file.seekg(0);
+    std::vector<std::uint64_t> image((static_cast<size_t>(size) + 7) / 8);
+    if (!file.read(reinterpret_cast<char*>(image.data()), size)) {
+        throw std::runtime_error("Could not read index file: " + path);
+    }
+    const char* base = reinterpret_cast<const char*>(image.data());
+    const IndexFile::Header& header = IndexFile::validate(base, static_cast<size_t>(size), path);
+
+    if (header.lineWidth > sizeof(line_type)) {
+        throw std::runtime_error("Index file '" + path + "' has 64-bit line numbers; load it with LargeIndexer");
+    }
+    if (header.lineCount > std::numeric_limits<count_type>::max() ||
+        header.tokenCount > std::numeric_limits<count_type>::max()) {
+        throw std::overflow_error("Index file '" + path + "' exceeds the index width; load it with LargeIndexer");
+    }
+    auto damaged = [&path](const std::string& reason) {
+        return std::runtime_error("Invalid index file '" + path + "': " + reason);
+    };
+
+    // Built on the side so a bad file leaves this index untouched
+    BasicIndexer loaded;
+    loaded.positional = (header.flags & IndexFile::FLAG_POSITIONAL) != 0;
+    loaded.caseInsensitive = (header.flags & IndexFile::FLAG_CASE_INSENSITIVE) != 0;
+    loaded.currentFilename.assign(base + header.filename.offset, header.filename.size);
+    loaded.lineCount = static_cast<count_type>(header.lineCount);
+    loaded.tokenCount = static_cast<count_type>(header.tokenCount);
+
+    const auto* sections = reinterpret_cast<const IndexFile::Section*>(base + header.directory.offset);
+    const auto* entries = reinterpret_cast<const IndexFile::Entry*>(base + header.entries.offset);
+    const char* strings = base + header.strings.offset;
+    const char* postings = base + header.postings.offset;
+    const auto* positionBytes = reinterpret_cast<const std::uint8_t*>(base + header.positions.offset);
+
+    for (int i = 0; i < NUM_SECTIONS; ++i) {
+        const IndexFile::Section& section = sections[i];
+        FrontCodedDictionary dictionary = IndexFile::sectionDictionary(base, header, section);
+        FrontCodedDictionary::Cursor keys = dictionary.cursor();
+        for (std::uint64_t e = section.firstEntry; e < section.firstEntry + section.entryCount; ++e) {
+            const IndexFile::Entry& entry = entries[e];
+            const std::string& entryKey = keys.next();
+            if (entryKey.size() != entry.keyLength) {
+                throw damaged("dictionary key does not match its entry");
+            }
+            const char* text = strings + entry.stringsOffset;
+            std::uint64_t remaining = header.strings.size - entry.stringsOffset - entry.tokenLength;
+            // restore() takes an empty key when it equals the token
+            std::string token = entry.tokenLength == 0 ? entryKey : std::string(text, entry.tokenLength);
+            std::string key = entry.tokenLength == 0 ? std::string() : entryKey;
+            text += entry.tokenLength;
+
+            std::vector<std::string> forms;
+            forms.reserve(entry.formCount);
+            for (std::uint32_t f = 0; f < entry.formCount; ++f) {
+                std::uint32_t length = 0;
+                if (remaining < sizeof(length)) throw damaged("surface forms outside the strings region");
+                std::memcpy(&length, text, sizeof(length));
+                if (remaining - sizeof(length) < length) throw damaged("surface forms outside the strings region");
+                forms.emplace_back(text + sizeof(length), length);
+                text += sizeof(length) + length;
+                remaining -= sizeof(length) + length;
+            }
+
+            // Sections must hold their own keys in strictly increasing order
+            if (getSectionIndex(entryKey[0]) != i ||
+                (!loaded.index[i].empty() && !(loaded.index[i].back().getKey() < entryKey))) {
+                throw damaged("entries are not in index order");
+            }
+
+            std::vector<line_type> lines(entry.postingsCount);
+            if (header.lineWidth == sizeof(line_type)) {
+                std::memcpy(lines.data(), postings + entry.postingsOffset * sizeof(line_type),
+                            entry.postingsCount * sizeof(line_type));
+            } else {
+                // 32-bit file into a 64-bit index
+                for (std::uint64_t p = 0; p < entry.postingsCount; ++p) {
+                    std::uint32_t line;
+                    std::memcpy(&line, postings + (entry.postingsOffset + p) * sizeof(line), sizeof(line));
+                    lines[p] = line;
+                }
+            }
+            std::vector<std::uint8_t> positions(positionBytes + entry.positionsOffset,
+                                                positionBytes + entry.positionsOffset + entry.positionsSize);
+
+            loaded.index[i].push_back(token_type::restore(std::move(token), std::move(key), std::move(forms),
+                                                          std::move(lines), std::move(positions), entry.lastPosition));
+        }
+    }
+    loaded.rebuildIndexes();
+    loaded.version = version + 1;
+    *this = std::move(loaded);
 }
 
-std::string Indexer::cleanToken(const std::string& word) {
+template <typename Traits>
+std::string BasicIndexer<Traits>::cleanToken(const std::string& word) {
     if (word.empty()) return word;
 
     // If the first character is non-alphabetic, keep the token as-is
@@ -119,16 +588,37 @@ std::string Indexer::cleanToken(const std::string& word) {
 }
 
 // Empties the entire index
-void Indexer::clear() {
+template <typename Traits>
+void BasicIndexer<Traits>::clear() {
     // Use iterators to clear each section
     for (auto it = index.begin(); it != index.end(); ++it) {
         it->clear();  // std::list::clear() automatically handles memory management
     }
+    for (auto it = lookup.begin(); it != lookup.end(); ++it) {
+        it->clear();
+    }
+    for (auto it = byLength.begin(); it != byLength.end(); ++it) {
+        it->clear();
+    }
+    for (auto it = fuzzyPending.begin(); it != fuzzyPending.end(); ++it) {
+        it->clear();
+    }
+    if (lazy) {
+        // Keep the cache counters; the version bump below retires every cached view
+        lazy->fuzzyTree.clear();
+        lazy->results.clear();
+    } else {
+        lazy = std::make_unique<LazyState>();  // moved-from index being reused
+    }
+    ++version;
     currentFilename = "";
+    lineCount = 0;
+    tokenCount = 0;
 }
 
 // Check if the index is empty
-bool Indexer::isEmpty() const {
+template <typename Traits>
+bool BasicIndexer<Traits>::isEmpty() const {
     // Use const_iterators to check each section
     for (auto it = index.cbegin(); it != index.cend(); ++it) {
         if (!it->empty()) {
@@ -138,125 +628,292 @@ bool Indexer::isEmpty() const {
     return true;
 }
 
+// Positional mode
+template <typename Traits>
+void BasicIndexer<Traits>::setPositional(bool enabled) {
+    if (positional != enabled) {
+        clear();  // existing entries would mix positional and plain postings
+        positional = enabled;
+    }
+}
+
+template <typename Traits>
+bool BasicIndexer<Traits>::isPositional() const {
+    return positional;
+}
+
+// Case-insensitive mode
+template <typename Traits>
+void BasicIndexer<Traits>::setCaseInsensitive(bool enabled) {
+    if (caseInsensitive != enabled) {
+        clear();  // existing keys were built under the other mode
+        caseInsensitive = enabled;
+    }
+}
+
+template <typename Traits>
+bool BasicIndexer<Traits>::isCaseInsensitive() const {
+    return caseInsensitive;
+}
+
+// Counters for the current file
+template <typename Traits>
+typename BasicIndexer<Traits>::count_type BasicIndexer<Traits>::getLineCount() const {
+    return lineCount;
+}
+
+template <typename Traits>
+typename BasicIndexer<Traits>::count_type BasicIndexer<Traits>::getTokenCount() const {
+    return tokenCount;
+}
+
+template <typename Traits>
+std::uint64_t BasicIndexer<Traits>::getVersion() const {
+    return version;
+}
+
+template <typename Traits>
+ResultCache::Stats BasicIndexer<Traits>::getCacheStats() const {
+    return lazy ? lazy->results.stats() : ResultCache::Stats{};
+}
+
+// Renders a view once per index version; later requests copy the cached bytes
+template <typename Traits>
+template <typename Render>
+void BasicIndexer<Traits>::writeCached(CachedView view, std::string argument, std::ostream& os, Render render) const {
+    if (!lazy) {  // moved-from index
+        BufferedWriter out(os);
+        render(out);
+        out.flush();
+        return;
+    }
+    ResultCache::Key key{static_cast<int>(view), std::move(argument), version};
+    ResultCache::value_type text = lazy->results.find(key);
+    if (!text) {
+        std::string rendered;
+        BufferedWriter out(rendered);
+        render(out);
+        text = lazy->results.insert(std::move(key), std::move(rendered));
+    }
+    os.write(text->data(), static_cast<std::streamsize>(text->size()));
+    os.flush();
+}
+
 // Displays the entire index
-void Indexer::print(std::ostream& os) const {
+template <typename Traits>
+void BasicIndexer<Traits>::print(std::ostream& os) const {
+    BufferedWriter out(os);
+    print(out);
+    out.flush();
+}
+
+template <typename Traits>
+void BasicIndexer<Traits>::print(BufferedWriter& out) const {
     if (!currentFilename.empty()) {
-        os << "Index for file: " << currentFilename << std::endl;
-        os << "================================" << std::endl;
+        out << "Index for file: " << currentFilename << '\n';
+        out << "================================" << '\n';
     }
 
     // Use iterators to traverse the array of sections
     for (size_t i = 0; i < index.size(); ++i) {
         if (!index[i].empty()) {
             if (i < 26) {
-                os << "--- Section " << static_cast<char>('A' + i) << " ---" << std::endl;
+                out << "--- Section " << static_cast<char>('A' + i) << " ---" << '\n';
             } else {
-                os << "--- Section [Non-alphabetic] ---" << std::endl;
+                out << "--- Section [Non-alphabetic] ---" << '\n';
             }
 
             // Use const_iterators to traverse each section's list
             for (auto tokenIt = index[i].cbegin(); tokenIt != index[i].cend(); ++tokenIt) {
-                tokenIt->print(os);
-                os << std::endl;
+                tokenIt->print(out);
+                out << '\n';
             }
-            os << std::endl;
+            out << '\n';
         }
     }
 }
 
+// Parallel print: the chunk list is built in one pass over the sections, then
+// workers render chunks while this thread writes finished ones in order
+template <typename Traits>
+void BasicIndexer<Traits>::printParallel(std::ostream& os, size_t threadCount) const {
+    struct Chunk {
+        size_t section;
+        typename section_type::const_iterator first;
+        typename section_type::const_iterator last;
+        bool opensSection;   // carries the section banner
+        bool closesSection;  // carries the blank line after the section
+    };
+    std::vector<Chunk> chunks;
+    for (size_t i = 0; i < index.size(); ++i) {
+        auto first = index[i].cbegin();
+        while (first != index[i].cend()) {
+            auto last = first;
+            // Weighted by postings so a few very frequent tokens do not serialize the dump
+            for (size_t weight = 0; weight < PRINT_CHUNK_WEIGHT && last != index[i].cend(); ++last) {
+                weight += 1 + last->getLineNumbers().size();
+            }
+            chunks.push_back({i, first, last, first == index[i].cbegin(), last == index[i].cend()});
+            first = last;
+        }
+    }
+
+    auto render = [this](const Chunk& chunk) {
+        std::string text;
+        BufferedWriter out(text);
+        if (chunk.opensSection) {
+            if (chunk.section < 26) {
+                out << "--- Section " << static_cast<char>('A' + chunk.section) << " ---" << '\n';
+            } else {
+                out << "--- Section [Non-alphabetic] ---" << '\n';
+            }
+        }
+        for (auto tokenIt = chunk.first; tokenIt != chunk.last; ++tokenIt) {
+            tokenIt->print(out);
+            out << '\n';
+        }
+        if (chunk.closesSection) {
+            out << '\n';
+        }
+        return text;
+    };
+
+    BufferedWriter out(os);
+    if (!currentFilename.empty()) {
+        out << "Index for file: " << currentFilename << '\n';
+        out << "================================" << '\n';
+    }
+
+    ThreadPool pool(threadCount);
+    const size_t window = pool.size() * 4;  // Rendered chunks allowed ahead of the writer
+    std::deque<std::future<std::string>> inFlight;
+    size_t next = 0;
+    for (size_t written = 0; written < chunks.size(); ++written) {
+        while (next < chunks.size() && inFlight.size() < window) {
+            auto task = std::make_shared<std::packaged_task<std::string()>>(
+                [&render, &chunk = chunks[next]] { return render(chunk); });
+            inFlight.push_back(task->get_future());
+            pool.enqueue([task] { (*task)(); });
+            ++next;
+        }
+        out << inFlight.front().get();
+        inFlight.pop_front();
+    }
+    out.flush();
+}
+
 // Displays all tokens using print
-void Indexer::displayAllTokens() const {
+template <typename Traits>
+void BasicIndexer<Traits>::displayAllTokens() const {
     print(std::cout);
 }
 
 // alias for displayAllTokens
-void Indexer::displayAll() const {
+template <typename Traits>
+void BasicIndexer<Traits>::displayAll() const {
     displayAllTokens();
 }
 
 // search by token length
-void Indexer::searchByLength(size_t length) const {
-    listByLength(length);
+template <typename Traits>
+void BasicIndexer<Traits>::searchByLength(size_t length, std::ostream& os) const {
+    listByLength(length, os);
 }
 
 // display specific section by index
-void Indexer::displaySection(int sectionIndex) const {
+template <typename Traits>
+void BasicIndexer<Traits>::displaySection(int sectionIndex, std::ostream& os) const {
+    writeCached(CachedView::Section, std::to_string(sectionIndex), os,
+                [&](BufferedWriter& out) { renderSection(sectionIndex, out); });
+}
+
+template <typename Traits>
+void BasicIndexer<Traits>::renderSection(int sectionIndex, BufferedWriter& out) const {
     if (sectionIndex < 0 || sectionIndex >= NUM_SECTIONS) {
-        std::cout << "Invalid section index: " << sectionIndex << std::endl;
+        out << "Invalid section index: " << sectionIndex << '\n';
         return;
     }
 
     if (index[sectionIndex].empty()) {
         if (sectionIndex < NUM_SECTIONS - 1) {
-            std::cout << "Section " << static_cast<char>('A' + sectionIndex) << " is empty." << std::endl;
+            out << "Section " << static_cast<char>('A' + sectionIndex) << " is empty." << '\n';
         } else {
-            std::cout << "Section [Non-alphabetic] is empty." << std::endl;
+            out << "Section [Non-alphabetic] is empty." << '\n';
         }
     } else {
         if (sectionIndex < NUM_SECTIONS - 1) {
-            std::cout << "--- Section " << static_cast<char>('A' + sectionIndex) << " ---" << std::endl;
+            out << "--- Section " << static_cast<char>('A' + sectionIndex) << " ---" << '\n';
         } else {
-            std::cout << "--- Section [Non-alphabetic] ---" << std::endl;
+            out << "--- Section [Non-alphabetic] ---" << '\n';
         }
 
         // Use const_iterators to display section contents
         for (auto it = index[sectionIndex].cbegin(); it != index[sectionIndex].cend(); ++it) {
-            it->print(std::cout);
-            std::cout << std::endl;
+            it->print(out);
+            out << '\n';
         }
     }
 }
 
 // Displays the tokens of a specified length
-void Indexer::listByLength(size_t length) const {
+template <typename Traits>
+void BasicIndexer<Traits>::listByLength(size_t length, std::ostream& os) const {
+    writeCached(CachedView::Length, std::to_string(length), os,
+                [&](BufferedWriter& out) { renderByLength(length, out); });
+}
+
+// Renders the tokens of a specified length, read from the by-length index
+template <typename Traits>
+void BasicIndexer<Traits>::renderByLength(size_t length, BufferedWriter& out) const {
     bool found = false;
 
-    std::cout << "Tokens of length " << length << ":" << std::endl;
+    out << "Tokens of length " << length << ":" << '\n';
 
-    // Use iterators to traverse each section
-    for (size_t i = 0; i < index.size(); ++i) {
-        if (!index[i].empty()) {
-            // Check if this section has any tokens of the specified length
-            bool sectionHasMatches = false;
-            std::ostringstream tempStream;
+    for (size_t i = 0; i < byLength.size(); ++i) {
+        auto bucket = byLength[i].find(length);
+        if (bucket == byLength[i].end()) continue;
 
-            // Use const_iterators to search for tokens of specified length
-            for (auto tokenIt = index[i].cbegin(); tokenIt != index[i].cend(); ++tokenIt) {
-                if (tokenIt->length() == length) {
-                    if (!sectionHasMatches) {
-                        // First match in this section - print section header
-                        if (found) {
-                            tempStream << std::endl; // Add spacing between sections
-                        }
-
-                        if (i < NUM_SECTIONS - 1) {
-                            tempStream << "--- Section " << static_cast<char>('A' + i) << " ---" << std::endl;
-                        } else {
-                            tempStream << "--- Section [Non-alphabetic] ---" << std::endl;
-                        }
-                        sectionHasMatches = true;
-                        found = true;
-                    }
-
-                    tokenIt->print(tempStream);
-                    tempStream << std::endl;
-                }
-            }
-
-            // Output the section if it had matches
-            if (sectionHasMatches) {
-                std::cout << tempStream.str();
-            }
+        if (found) {
+            out << '\n'; // Add spacing between sections
+        }
+        if (i < NUM_SECTIONS - 1) {
+            out << "--- Section " << static_cast<char>('A' + i) << " ---" << '\n';
+        } else {
+            out << "--- Section [Non-alphabetic] ---" << '\n';
         }
+        found = true;
+
+        // Bucket entries are already in section order
+        formatTokens<line_type>(bucket->second, out);
     }
 
     if (!found) {
-        std::cout << "No tokens of length " << length << " found." << std::endl;
+        out << "No tokens of length " << length << " found." << '\n';
     }
 }
 
+// Tokens of a specified length, in index order
+template <typename Traits>
+std::vector<const typename BasicIndexer<Traits>::token_type*> BasicIndexer<Traits>::findByLength(size_t length) const {
+    std::vector<const token_type*> result;
+    for (auto sectionIt = byLength.cbegin(); sectionIt != byLength.cend(); ++sectionIt) {
+        auto bucket = sectionIt->find(length);
+        if (bucket != sectionIt->end()) {
+            result.insert(result.end(), bucket->second.cbegin(), bucket->second.cend());
+        }
+    }
+    return result;
+}
+
 // Displays the tokens in a specified section
-void Indexer::viewBySection(char section) const {
+template <typename Traits>
+void BasicIndexer<Traits>::viewBySection(char section, std::ostream& os) const {
+    writeCached(CachedView::SectionByChar, std::string(1, section), os,
+                [&](BufferedWriter& out) { renderSectionByChar(section, out); });
+}
+
+template <typename Traits>
+void BasicIndexer<Traits>::renderSectionByChar(char section, BufferedWriter& out) const {
     int sectionIndex;
 
     if (isalpha(section)) {
@@ -267,21 +924,343 @@ void Indexer::viewBySection(char section) const {
 
     if (sectionIndex >= 0 && sectionIndex < NUM_SECTIONS) {
         if (sectionIndex < NUM_SECTIONS - 1) {
-            std::cout << "--- Section " << static_cast<char>(toupper(section)) << " ---" << std::endl;
+            out << "--- Section " << static_cast<char>(toupper(section)) << " ---" << '\n';
         } else {
-            std::cout << "--- Section [Non-alphabetic] ---" << std::endl;
+            out << "--- Section [Non-alphabetic] ---" << '\n';
         }
 
         if (index[sectionIndex].empty()) {
-            std::cout << "No tokens in this section." << std::endl;
+            out << "No tokens in this section." << '\n';
         } else {
             // Use const_iterators to display section contents
             for (auto it = index[sectionIndex].cbegin(); it != index[sectionIndex].cend(); ++it) {
-                it->print(std::cout);
-                std::cout << std::endl;
+                it->print(out);
+                out << '\n';
             }
         }
     } else {
-        std::cout << "Invalid section: " << section << std::endl;
+        out << "Invalid section: " << section << '\n';
+    }
+}
+
+// Lookup of a single token
+template <typename Traits>
+const typename BasicIndexer<Traits>::token_type* BasicIndexer<Traits>::findToken(const std::string& token) const {
+    if (token.empty()) return nullptr;
+
+    const lookup_type& sectionLookup = lookup[getSectionIndex(token[0])];
+    auto it = caseInsensitive ? sectionLookup.find(std::string_view(foldCase(token)))
+                              : sectionLookup.find(std::string_view(token));
+    return it == sectionLookup.end() ? nullptr : &*it->second;
+}
+
+// Tokens with at least one occurrence within lines [lo, hi], in index order
+template <typename Traits>
+std::vector<const typename BasicIndexer<Traits>::token_type*>
+BasicIndexer<Traits>::tokensInLines(line_type lo, line_type hi) const {
+    std::vector<const token_type*> result;
+    if (lo > hi) return result;
+
+    for (auto sectionIt = index.cbegin(); sectionIt != index.cend(); ++sectionIt) {
+        for (auto tokenIt = sectionIt->cbegin(); tokenIt != sectionIt->cend(); ++tokenIt) {
+            // Postings are sorted: first/last line reject most tokens without a search
+            const std::vector<line_type>& lines = tokenIt->getLineNumbers();
+            if (lines.front() > hi || lines.back() < lo) continue;
+
+            size_t first = tokenIt->lowerBound(lo);
+            if (first < lines.size() && lines[first] <= hi) {
+                result.push_back(&*tokenIt);
+            }
+        }
+    }
+    return result;
+}
+
+// Occurrences of a token within lines [lo, hi]
+template <typename Traits>
+std::span<const typename BasicIndexer<Traits>::line_type>
+BasicIndexer<Traits>::occurrences(const std::string& token, line_type lo, line_type hi) const {
+    const token_type* found = findToken(token);
+    if (found == nullptr) return {};
+    return found->linesInRange(lo, hi);
+}
+
+// Tokens starting with prefix
+template <typename Traits>
+std::vector<const typename BasicIndexer<Traits>::token_type*>
+BasicIndexer<Traits>::findPrefix(const std::string& prefix) const {
+    std::vector<const token_type*> result;
+
+    if (prefix.empty()) {
+        // Every token matches the empty prefix
+        for (auto sectionIt = index.cbegin(); sectionIt != index.cend(); ++sectionIt) {
+            for (auto tokenIt = sectionIt->cbegin(); tokenIt != sectionIt->cend(); ++tokenIt) {
+                result.push_back(&*tokenIt);
+            }
+        }
+        return result;
+    }
+
+    // All matches share the prefix's section and form one sorted run in it
+    const std::string key = caseInsensitive ? foldCase(prefix) : prefix;
+    const lookup_type& sectionLookup = lookup[getSectionIndex(key[0])];
+    for (auto it = sectionLookup.lower_bound(std::string_view(key));
+         it != sectionLookup.end() && it->first.starts_with(key); ++it) {
+        result.push_back(&*it->second);
+    }
+    return result;
+}
+
+// Range iterator
+template <typename Traits>
+BasicIndexer<Traits>::TokenRange::const_iterator::const_iterator(const std::array<section_type, NUM_SECTIONS>& sections,
+                                                                 int section,
+                                                                 typename section_type::const_iterator current,
+                                                                 int lastSection)
+    : sections(&sections), section(section), lastSection(lastSection), current(current) {
+    skipExhausted();
+}
+
+template <typename Traits>
+void BasicIndexer<Traits>::TokenRange::const_iterator::skipExhausted() {
+    while (section < lastSection && current == (*sections)[section].cend()) {
+        ++section;
+        current = (*sections)[section].cbegin();
     }
-}
\ No newline at end of file
+}
+
+template <typename Traits>
+typename BasicIndexer<Traits>::TokenRange::const_iterator::reference
+BasicIndexer<Traits>::TokenRange::const_iterator::operator*() const {
+    return *current;
+}
+
+template <typename Traits>
+typename BasicIndexer<Traits>::TokenRange::const_iterator::pointer
+BasicIndexer<Traits>::TokenRange::const_iterator::operator->() const {
+    return &*current;
+}
+
+template <typename Traits>
+typename BasicIndexer<Traits>::TokenRange::const_iterator&
+BasicIndexer<Traits>::TokenRange::const_iterator::operator++() {
+    ++current;
+    skipExhausted();
+    return *this;
+}
+
+template <typename Traits>
+typename BasicIndexer<Traits>::TokenRange::const_iterator
+BasicIndexer<Traits>::TokenRange::const_iterator::operator++(int) {
+    const_iterator previous = *this;
+    ++*this;
+    return previous;
+}
+
+// Iterators into different lists are never compared
+template <typename Traits>
+bool BasicIndexer<Traits>::TokenRange::const_iterator::operator==(const const_iterator& other) const {
+    return section == other.section && current == other.current;
+}
+
+template <typename Traits>
+BasicIndexer<Traits>::TokenRange::TokenRange(const_iterator first, const_iterator last) : first(first), last(last) {}
+
+template <typename Traits>
+typename BasicIndexer<Traits>::TokenRange::const_iterator BasicIndexer<Traits>::TokenRange::begin() const {
+    return first;
+}
+
+template <typename Traits>
+typename BasicIndexer<Traits>::TokenRange::const_iterator BasicIndexer<Traits>::TokenRange::end() const {
+    return last;
+}
+
+template <typename Traits>
+bool BasicIndexer<Traits>::TokenRange::empty() const {
+    return first == last;
+}
+
+// Entries between lo and hi inclusive: lower_bound in lo's section, upper_bound in hi's
+template <typename Traits>
+typename BasicIndexer<Traits>::TokenRange BasicIndexer<Traits>::range(const std::string& lo, const std::string& hi) const {
+    std::string foldedLo;
+    std::string foldedHi;
+    std::string_view loKey(lo);
+    std::string_view hiKey(hi);
+    if (caseInsensitive) {
+        foldedLo = foldCase(lo);
+        foldedHi = foldCase(hi);
+        loKey = foldedLo;
+        hiKey = foldedHi;
+    }
+
+    int firstSection = loKey.empty() ? 0 : getSectionIndex(loKey[0]);
+    int lastSection = hiKey.empty() ? NUM_SECTIONS - 1 : getSectionIndex(hiKey[0]);
+
+    auto toList = [this](int section, typename lookup_type::const_iterator found) {
+        return found == lookup[section].cend() ? index[section].cend()
+                                               : typename section_type::const_iterator(found->second);
+    };
+    auto stop = hiKey.empty() ? index[lastSection].cend() : toList(lastSection, lookup[lastSection].upper_bound(hiKey));
+    typename TokenRange::const_iterator last(index, lastSection, stop, lastSection);
+
+    if (firstSection > lastSection || (firstSection == lastSection && !hiKey.empty() && loKey > hiKey)) {
+        return TokenRange(last, last);  // lo sorts after hi
+    }
+    auto start = toList(firstSection, lookup[firstSection].lower_bound(loKey));
+    return TokenRange(typename TokenRange::const_iterator(index, firstSection, start, lastSection), last);
+}
+
+// Tokens matching a glob pattern
+template <typename Traits>
+std::vector<const typename BasicIndexer<Traits>::token_type*>
+BasicIndexer<Traits>::findWildcard(const std::string& pattern) const {
+    WildcardPattern matcher(caseInsensitive ? foldCase(pattern) : pattern);
+    if (!matcher.hasWildcards()) {
+        const token_type* token = findToken(pattern);
+        return token == nullptr ? std::vector<const token_type*>() : std::vector<const token_type*>{token};
+    }
+
+    std::vector<const token_type*> result;
+    std::vector<const token_type*> candidates = findPrefix(matcher.prefix());
+    for (auto it = candidates.cbegin(); it != candidates.cend(); ++it) {
+        if (matcher.matches((*it)->getKey())) {
+            result.push_back(*it);
+        }
+    }
+    return result;
+}
+
+// Bring the fuzzy tree up to date with entries created since the last search
+template <typename Traits>
+void BasicIndexer<Traits>::syncFuzzyTree() const {
+    for (auto sectionIt = fuzzyPending.begin(); sectionIt != fuzzyPending.end(); ++sectionIt) {
+        for (auto it = sectionIt->cbegin(); it != sectionIt->cend(); ++it) {
+            lazy->fuzzyTree.insert((*it)->getKey(), *it);
+        }
+        sectionIt->clear();
+    }
+}
+
+// Tokens within maxDistance edits of token
+template <typename Traits>
+std::vector<typename BasicIndexer<Traits>::similar_type>
+BasicIndexer<Traits>::findSimilar(const std::string& token, size_t maxDistance) const {
+    std::vector<similar_type> result;
+    if (!lazy || token.empty()) return result;  // moved-from index
+
+    const std::string query = caseInsensitive ? foldCase(token) : token;
+    {
+        // Searches on a shared index only take the lock exclusively while there are
+        // entries to insert; fuzzyPending only shrinks under the exclusive lock
+        std::shared_lock<std::shared_mutex> readLock(lazy->mutex);
+        bool pending = std::any_of(fuzzyPending.cbegin(), fuzzyPending.cend(),
+                                   [](const std::vector<const token_type*>& section) { return !section.empty(); });
+        if (pending) {
+            readLock.unlock();
+            {
+                std::unique_lock<std::shared_mutex> writeLock(lazy->mutex);
+                syncFuzzyTree();  // a no-op if another search got there first
+            }
+            readLock.lock();
+        }
+        result = lazy->fuzzyTree.search(query, maxDistance);
+    }
+
+    std::sort(result.begin(), result.end(), [](const similar_type& a, const similar_type& b) {
+        return a.second != b.second ? a.second < b.second : a.first->getKey() < b.first->getKey();
+    });
+    return result;
+}
+
+// Closest entry, most frequent among equally close ones
+template <typename Traits>
+const typename BasicIndexer<Traits>::token_type* BasicIndexer<Traits>::suggestToken(const std::string& token) const {
+    std::vector<similar_type> candidates = findSimilar(token, MAX_SUGGESTION_DISTANCE);
+    const token_type* best = nullptr;
+    for (auto it = candidates.cbegin(); it != candidates.cend() && it->second == candidates.front().second; ++it) {
+        if (best == nullptr || it->first->getLineNumbers().size() > best->getLineNumbers().size()) {
+            best = it->first;
+        }
+    }
+    return best;
+}
+
+// The k most frequent tokens
+template <typename Traits>
+std::vector<const typename BasicIndexer<Traits>::token_type*>
+BasicIndexer<Traits>::topK(size_t k, std::optional<int> sectionIndex, std::optional<size_t> length) const {
+    std::vector<const token_type*> result;
+    if (k == 0) return result;
+    if (sectionIndex && (*sectionIndex < 0 || *sectionIndex >= NUM_SECTIONS)) return result;
+
+    // More occurrences first, then key order
+    auto ranksBefore = [](const token_type* a, const token_type* b) {
+        size_t countA = a->getLineNumbers().size();
+        size_t countB = b->getLineNumbers().size();
+        return countA != countB ? countA > countB : a->getKey() < b->getKey();
+    };
+
+    // Best k of one section, kept in a bounded heap whose top is the weakest entry
+    auto sectionTopK = [&](int section) {
+        std::vector<const token_type*> heap;
+        auto consider = [&](const token_type* entry) {
+            if (heap.size() < k) {
+                heap.push_back(entry);
+                std::push_heap(heap.begin(), heap.end(), ranksBefore);
+            } else if (ranksBefore(entry, heap.front())) {
+                std::pop_heap(heap.begin(), heap.end(), ranksBefore);
+                heap.back() = entry;
+                std::push_heap(heap.begin(), heap.end(), ranksBefore);
+            }
+        };
+        if (length) {
+            auto bucket = byLength[section].find(*length);
+            if (bucket != byLength[section].end()) {
+                std::for_each(bucket->second.cbegin(), bucket->second.cend(), consider);
+            }
+        } else {
+            for (auto it = index[section].cbegin(); it != index[section].cend(); ++it) {
+                consider(&*it);
+            }
+        }
+        return heap;
+    };
+
+    int first = sectionIndex ? *sectionIndex : 0;
+    int last = sectionIndex ? *sectionIndex + 1 : NUM_SECTIONS;
+    size_t entries = 0;
+    for (int i = first; i < last; ++i) {
+        entries += index[i].size();
+    }
+
+    // Large indexes scan their sections on worker threads
+    std::vector<std::vector<const token_type*>> partial(static_cast<size_t>(last - first));
+    if (entries >= PARALLEL_TOP_K_THRESHOLD && last - first > 1) {
+        std::vector<std::future<std::vector<const token_type*>>> workers;
+        for (int i = first; i < last; ++i) {
+            workers.push_back(std::async(std::launch::async, sectionTopK, i));
+        }
+        for (size_t i = 0; i < workers.size(); ++i) {
+            partial[i] = workers[i].get();
+        }
+    } else {
+        for (int i = first; i < last; ++i) {
+            partial[static_cast<size_t>(i - first)] = sectionTopK(i);
+        }
+    }
+
+    // Merge: at most k survivors per section
+    for (auto it = partial.begin(); it != partial.end(); ++it) {
+        result.insert(result.end(), it->cbegin(), it->cend());
+    }
+    size_t keep = std::min(k, result.size());
+    std::partial_sort(result.begin(), result.begin() + static_cast<std::ptrdiff_t>(keep), result.end(), ranksBefore);
+    result.resize(keep);
+    return result;
+}
+
+// Explicit instantiations for the supported index widths
+template class BasicIndexer<CompactIndexTraits>;
+template class BasicIndexer<LargeIndexTraits>;
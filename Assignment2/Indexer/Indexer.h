@@ -7,74 +7,302 @@
 #define INDEXER_H
 
 #include <array>
+#include <cstdint>
+#include <functional>
+#include <iterator>
 #include <list>
+#include <map>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <vector>
 #include <iostream>
 #include "../IndexedToken/IndexedToken.h"
+#include "../WildcardPattern/WildcardPattern.h"
+#include "../BKTree/BKTree.h"
+#include "../ResultCache/ResultCache.h"
+#include "../IndexFile/IndexFile.h"
 
 
 /**
- * @class Indexer
+ * @brief Compile-time widths for an index.
+ * line_type is the posting (line number) type stored in every IndexedToken,
+ * count_type is used for the per-file line and token counters.
+ */
+struct CompactIndexTraits {
+    using line_type = std::uint32_t;
+    using count_type = std::uint32_t;
+};
+
+struct LargeIndexTraits {
+    using line_type = std::uint64_t;
+    using count_type = std::uint64_t;
+};
+
+/**
+ * @class BasicIndexer
  * @brief Manages a collection of 27 sections (A-Z plus non-alphabetic)
  * where each section contains a sorted list of IndexedToken objects.
-
+ *
+ * Traits selects the posting and counter widths; inputs that would overflow
+ * them are rejected with std::overflow_error instead of wrapping silently.
  */
-class Indexer {
+template <typename Traits>
+class BasicIndexer {
 public:
+    using line_type = typename Traits::line_type;
+    using count_type = typename Traits::count_type;
+    using token_type = BasicIndexedToken<line_type>;
+    using position_type = typename token_type::position_type;
+
     static const int NUM_SECTIONS = 27;  // 26 letters + 1 for non-alphabetic
+    static const size_t MAX_SUGGESTION_DISTANCE = 2;  // Edits allowed by suggestToken
+    static const size_t PARALLEL_TOP_K_THRESHOLD = 65536;  // Entries before topK uses worker threads
+    static const size_t PRINT_CHUNK_WEIGHT = 65536;  // Entries plus postings rendered per printParallel task
+
+    // A fuzzy match and its edit distance from the query
+    using similar_type = std::pair<const token_type*, size_t>;
 
 private:
-    std::array<std::list<IndexedToken>, NUM_SECTIONS> index;
+    using section_type = std::list<token_type>;
+    // Sorted lookup into a section; keys view the token text stored in the list node
+    using lookup_type = std::map<std::string_view, typename section_type::iterator, std::less<>>;
+
+    std::array<section_type, NUM_SECTIONS> index;
+    std::array<lookup_type, NUM_SECTIONS> lookup;  // O(log n) access into each section
+    // Secondary index: per section, token length -> entries of that length in section order
+    std::array<std::map<size_t, std::vector<const token_type*>>, NUM_SECTIONS> byLength;
     std::string currentFilename;
+    count_type lineCount = 0;   // Lines read from the current file
+    count_type tokenCount = 0;  // Tokens indexed from the current file
+    bool positional = false;    // Record each token's position within its line
+    bool caseInsensitive = false;  // Key, order and match tokens on their lower-case form
+    std::uint64_t version = 0;  // Bumped on every change; keys the result cache
+
+    // Query structures built on first use. They sit behind a pointer so the
+    // index stays movable while they carry their own lock.
+    struct LazyState {
+        std::shared_mutex mutex;
+        BKTree<const token_type*> fuzzyTree;  // Edit-distance tree over the keys
+        ResultCache results;                  // Rendered section and length views
+    };
+    std::unique_ptr<LazyState> lazy;
+    // Entries created since the fuzzy tree was last brought up to date, per section
+    mutable std::array<std::vector<const token_type*>, NUM_SECTIONS> fuzzyPending;
 
     // Helper method to clean tokens (remove unwanted punctuation) and handle Hashtag values (non alphabetic)
-    std::string cleanToken(const std::string& word);
+    static std::string cleanToken(const std::string& word);
+
+    // Error for a line or token counter that would overflow count_type
+    std::overflow_error widthError(const std::string& counter) const;
+
+    // Rebuild the lookup maps and by-length index from the section lists (after a copy)
+    void rebuildIndexes();
+
+    // Move pending entries into the fuzzy tree; caller holds lazy->mutex exclusively
+    void syncFuzzyTree() const;
+
+    // Views served from the result cache
+    enum class CachedView { Section, Length, SectionByChar };
+    // Write the cached rendering of a view, rendering and caching it on a miss
+    template <typename Render>
+    void writeCached(CachedView view, std::string argument, std::ostream& os, Render render) const;
+
+    // Uncached renderers behind displaySection / listByLength / viewBySection
+    void renderSection(int sectionIndex, BufferedWriter& out) const;
+    void renderByLength(size_t length, BufferedWriter& out) const;
+    void renderSectionByChar(char section, BufferedWriter& out) const;
 
 public:
+    /**
+     * @class TokenRange
+     * @brief Lazy view over consecutive index entries, possibly spanning sections.
+     * Iterates the lists in place; the index must not change while it is in use.
+     */
+    class TokenRange {
+    public:
+        class const_iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = token_type;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const token_type*;
+            using reference = const token_type&;
+
+        private:
+            const std::array<section_type, NUM_SECTIONS>* sections = nullptr;
+            int section = 0;      // Section of current
+            int lastSection = 0;  // Iteration never leaves this section
+            typename section_type::const_iterator current;
+
+            // Step over exhausted sections up to lastSection
+            void skipExhausted();
+
+        public:
+            const_iterator() = default;
+            const_iterator(const std::array<section_type, NUM_SECTIONS>& sections, int section,
+                           typename section_type::const_iterator current, int lastSection);
+
+            reference operator*() const;
+            pointer operator->() const;
+            const_iterator& operator++();
+            const_iterator operator++(int);
+            bool operator==(const const_iterator& other) const;
+        };
+
+    private:
+        const_iterator first;
+        const_iterator last;
+
+    public:
+        TokenRange(const_iterator first, const_iterator last);
+        const_iterator begin() const;
+        const_iterator end() const;
+        bool empty() const;
+    };
+
     // Default constructor
-    Indexer();
+    BasicIndexer();
 
-    // Copy constructor
-    Indexer(const Indexer& other) = default;
+    // Copy constructor - lookup maps are rebuilt to point at the copied lists
+    BasicIndexer(const BasicIndexer& other);
 
     // Move constructor
-    Indexer(Indexer&& other) noexcept = default;
+    BasicIndexer(BasicIndexer&& other) noexcept = default;
 
     // Copy assignment operator
-    Indexer& operator=(const Indexer& other) = default;
+    BasicIndexer& operator=(const BasicIndexer& other);
 
     // Move assignment operator
-    Indexer& operator=(Indexer&& other) noexcept = default;
+    BasicIndexer& operator=(BasicIndexer&& other) noexcept = default;
 
     // Destructor
-    ~Indexer() = default;
+    ~BasicIndexer() = default;
 
     // Process a single token and add it to the appropriate section
-    void processToken(const char* text, int lineNumber);
-    void processToken(const std::string& token, int lineNumber);
+    void processToken(const char* text, line_type lineNumber);
+    void processToken(const std::string& token, line_type lineNumber);
+    // Positional form; the position is ignored unless positional mode is on
+    void processToken(const char* text, line_type lineNumber, position_type position);
 
     // Process an entire text file
     void processTextFile(const std::string& filename);
 
+    // Incremental indexing: the cleaned tokens of a line, in order (a token's
+    // position is its index), and adding such a line under a given line number.
+    // processLine indexes text as the next line (getLineCount() + 1).
+    static std::vector<std::string> tokenizeLine(const std::string& line);
+    void addLine(line_type lineNumber, const std::vector<std::string>& tokens);
+    void processLine(const std::string& line);
+
+    // Persist the index in the binary IndexFile format (written to path + ".tmp",
+    // then renamed over path). Throws std::runtime_error if the file cannot be written.
+    void save(const std::string& path) const;
+    // Replace the index with one saved by save(): a bulk read, checksum validation and
+    // a rebuild of the in-memory lookups; no text is re-tokenized. Files saved by a
+    // LargeIndexer need a LargeIndexer. Throws std::runtime_error for unreadable or
+    // damaged files, leaving the index unchanged.
+    void load(const std::string& path);
+
+    /**
+     * @brief k-way merge of indexes over consecutive runs of lines: part i's line numbers
+     * are shifted by lineOffsets[i] and must all follow those of the parts before it.
+     * Sections are merged key by key and each key's postings concatenated in part order.
+     * The parts must share positional and case modes; throws std::invalid_argument otherwise.
+     */
+    static BasicIndexer merged(std::span<const BasicIndexer* const> parts, std::span<const line_type> lineOffsets);
+    // Two-way form of merged(): other's lines, shifted by lineOffset, follow this index's
+    void merge(const BasicIndexer& other, line_type lineOffset);
+
     // Clear all sections
     void clear();
 
     // Check if the index is empty
     bool isEmpty() const;
 
+    // Positional mode (needed for phrase / NEAR queries); changing it clears the index
+    void setPositional(bool enabled);
+    bool isPositional() const;
+
+    // Case-insensitive mode: "Error", "ERROR" and "error" share one entry (and its
+    // postings) ordered by the folded key; spellings are kept for display.
+    // Changing it clears the index.
+    void setCaseInsensitive(bool enabled);
+    bool isCaseInsensitive() const;
+
+    // Counters for the current file
+    count_type getLineCount() const;
+    count_type getTokenCount() const;
+
+    // Changes whenever the contents change (every processToken and clear)
+    std::uint64_t getVersion() const;
+
+    // Hit/miss counters and size of the section / length view cache
+    ResultCache::Stats getCacheStats() const;
+
     // Display functions
     void print(std::ostream& os = std::cout) const;
+    void print(BufferedWriter& out) const;  // caller decides when to flush
+    // Same bytes as print(os): sections, and sub-ranges of large sections, are rendered
+    // into separate buffers on threadCount workers (0 = one per hardware thread) and
+    // written in section order. At most a few chunks per worker are held at once.
+    void printParallel(std::ostream& os, size_t threadCount = 0) const;
     void displayAllTokens() const;
     void displayAll() const;  // alias for displayAllTokens
 
-    // Search and filter functions
-    void searchByLength(size_t length) const;
-    void listByLength(size_t length) const;
-    void viewBySection(char section) const;
-    void displaySection(int sectionIndex) const;
+    // Search and filter functions. Repeated views of an unchanged index are
+    // served from an LRU cache of their rendered text.
+    void searchByLength(size_t length, std::ostream& os = std::cout) const;
+    void listByLength(size_t length, std::ostream& os = std::cout) const;
+    void viewBySection(char section, std::ostream& os = std::cout) const;
+    void displaySection(int sectionIndex, std::ostream& os = std::cout) const;
+
+    // Tokens of a given length in index order (from the by-length index)
+    std::vector<const token_type*> findByLength(size_t length) const;
+
+    // Lookup of a single token; nullptr if it is not indexed
+    const token_type* findToken(const std::string& token) const;
+
+    // Line-range queries (inclusive bounds)
+    std::vector<const token_type*> tokensInLines(line_type lo, line_type hi) const;
+    std::span<const line_type> occurrences(const std::string& token, line_type lo, line_type hi) const;
+
+    // Tokens starting with prefix, in index order; binary search to the first match
+    std::vector<const token_type*> findPrefix(const std::string& prefix) const;
+    // Entries from lo to hi inclusive, in index order (section, then key). An empty
+    // lo or hi leaves that end open. Jumps to lo with a lookup search and streams
+    // across the sections in between; nothing outside the range is visited.
+    TokenRange range(const std::string& lo, const std::string& hi) const;
+    // Tokens matching a glob pattern ('*' and '?'); narrowed by the pattern's literal prefix
+    std::vector<const token_type*> findWildcard(const std::string& pattern) const;
+
+    // Tokens within maxDistance edits of token, closest first (BK-tree search)
+    std::vector<similar_type> findSimilar(const std::string& token, size_t maxDistance) const;
+    // "Did you mean": the closest entry within MAX_SUGGESTION_DISTANCE, most frequent on ties
+    const token_type* suggestToken(const std::string& token) const;
+
+    // The k most frequent tokens (by occurrences, then key), optionally limited to one
+    // section (0-26) and/or one token length. Bounded heaps per section, then a merge.
+    std::vector<const token_type*> topK(size_t k, std::optional<int> sectionIndex = std::nullopt,
+                                        std::optional<size_t> length = std::nullopt) const;
 };
 
+// Compact index used by the UI: 32-bit line numbers and counters
+using Indexer = BasicIndexer<CompactIndexTraits>;
+// Index for huge inputs: 64-bit line numbers and counters
+using LargeIndexer = BasicIndexer<LargeIndexTraits>;
+
+extern template class BasicIndexer<CompactIndexTraits>;
+extern template class BasicIndexer<LargeIndexTraits>;
+
 // Helper function to determine section index (0-26) for a character
 int getSectionIndex(char c);
 
-#endif // INDEXER_H
\ No newline at end of file
+// Helper function producing the case-folded (lower-case) key for a token
+std::string foldCase(std::string_view text);
+
+#endif // INDEXER_H
@@ -9,9 +9,20 @@
 #include <new>  // For std::bad_alloc
 #include <stdexcept>  // For std::exception
 #include <string>
+#include <vector>
+#include "../QueryEngine/QueryEngine.h"
+#include "../BatchQueryRunner/BatchQueryRunner.h"
+#include "../IndexExporter/IndexExporter.h"
 
 // Constructor
-IndexerUI::IndexerUI() : currentFilename("") {}
+IndexerUI::IndexerUI() : index(positionalIndex()), currentFilename("") {}
+
+// Initial (empty) version; keeps word positions for phrase and NEAR queries
+Indexer IndexerUI::positionalIndex() {
+  Indexer initial;
+  initial.setPositional(true);
+  return initial;
+}
 
 // Main application loop with error handling
 void IndexerUI::run() {
@@ -36,6 +47,21 @@ void IndexerUI::run() {
           processViewSection();
           break;
         case 5:
+          processBooleanQuery();
+          break;
+        case 6:
+          processBatchQueries();
+          break;
+        case 7:
+          processExport();
+          break;
+        case 8:
+          processSaveIndex();
+          break;
+        case 9:
+          processLoadIndex();
+          break;
+        case 10:
           std::cout << "\nExiting program. Goodbye!" << std::endl;
           break;
       }
@@ -43,7 +69,7 @@ void IndexerUI::run() {
       std::cerr << "\n********\nFATAL ERROR: Memory allocation failed: "
                 << e.what() << "\n********" << std::endl;
       // Consider exiting or trying to recover minimally
-      choice = 5;  // Force exit on memory exhaustion
+      choice = EXIT_CHOICE;  // Force exit on memory exhaustion
     } catch (const std::exception& e) {
       std::cerr << "\n********\nERROR: An exception occurred: " << e.what()
                 << "\n********" << std::endl;
@@ -53,7 +79,7 @@ void IndexerUI::run() {
                 << std::endl;
       // Continue the loop
     }
-  } while (choice != 5);
+  } while (choice != EXIT_CHOICE);
 }
 
 // Display menu options
@@ -63,16 +89,21 @@ void IndexerUI::displayMenu() const {
             << "2. Show tokens in all sections\n"
             << "3. Find tokens by length\n"
             << "4. View tokens by section\n"
-            << "5. Exit\n"
+            << "5. Run a boolean query (AND, OR, NOT, \"phrase\", NEAR/k)\n"
+            << "6. Run queries from a file\n"
+            << "7. Export the index (JSON Lines, CSV or binary)\n"
+            << "8. Save the index to a file\n"
+            << "9. Load a saved index\n"
+            << "10. Exit\n"
             << "==================================\n";
 }
 
-// Robustly get and validate user's menu choice (1-5)
+// Robustly get and validate user's menu choice (1-EXIT_CHOICE)
 int IndexerUI::getUserChoice() const {
   int choice = 0;
-  std::cout << "Enter your choice (1-5): ";
-  while (!(std::cin >> choice) || choice < 1 || choice > 5) {
-    std::cerr << "Invalid input. Please enter a number between 1 and 5: ";
+  std::cout << "Enter your choice (1-" << EXIT_CHOICE << "): ";
+  while (!(std::cin >> choice) || choice < 1 || choice > EXIT_CHOICE) {
+    std::cerr << "Invalid input. Please enter a number between 1 and " << EXIT_CHOICE << ": ";
     std::cin.clear();                        // Clear the error flag on cin
     std::cin.ignore(max_stream_size, '\n');  // Discard the invalid input from
                                              // the buffer up to the newline
@@ -157,12 +188,25 @@ std::string IndexerUI::getFileName() const {
   return filename;
 }
 
+std::string IndexerUI::getQueryString() const {
+  std::string query;
+  std::cout << "Enter query (e.g. \"connection reset\" OR (timeout NEAR/3 retry) AND NOT debug): ";
+  if (!std::getline(std::cin, query) || query.empty()) {
+    std::cerr << "Error: Invalid query input.\n";
+    if (std::cin.fail() && !std::cin.eof()) {
+      std::cin.clear();
+      std::cin.ignore(max_stream_size, '\n');
+    }
+  }
+  return query;
+}
+
 // Process: Index a file
 void IndexerUI::processIndexFile() {
-  // Check if index needs clearing
-  if (!index.isEmpty()) {
-    // Prompts the user to confirm clearing existing data
-    std::cout << "Index is not empty. Clear existing index?";
+  // Check if index needs replacing
+  if (!index.acquire()->isEmpty()) {
+    // Prompts the user to confirm replacing existing data
+    std::cout << "Index is not empty. Replace existing index?";
     char confirm = getConfirmation();  // Use robust input helper
     if (confirm != 'y') {
       std::cout << "Indexing cancelled.\n";
@@ -171,35 +215,184 @@ void IndexerUI::processIndexFile() {
   }
 
   std::string filename = getFileName();
-  index.processTextFile(filename);
+  if (!std::ifstream(filename).is_open()) {
+    std::cerr << "Error: Could not open file '" << filename << "'" << std::endl;
+    return;  // The current index stays in place
+  }
+  // Built off to the side; queries see the old index until the new one is published
+  index.rebuild([&filename](Indexer& next) { next.processTextFile(filename); });
 }
 
 // Process: Display all tokens
 void IndexerUI::processDisplayAll() {
-  if (index.isEmpty()) {
+  // Held for the whole operation, so a concurrent rebuild cannot change it midway
+  VersionedIndex::snapshot_type snapshot = index.acquire();
+  if (snapshot->isEmpty()) {
     std::cout << "\nIndex is empty.\n";
     return;
   }
-  index.displayAll();
+  snapshot->displayAll();
 }
 // Process: Search by length
 void IndexerUI::processShowByLength() {
-  if (index.isEmpty()) {
+  VersionedIndex::snapshot_type snapshot = index.acquire();
+  if (snapshot->isEmpty()) {
     std::cout << "\nIndex is empty.\n";
     return;
   }
   size_t length = getSearchLength();
-  index.searchByLength(length);
+  snapshot->searchByLength(length);
 }
 // Process: View by section
 void IndexerUI::processViewSection() {
-  if (index.isEmpty()) {
+  VersionedIndex::snapshot_type snapshot = index.acquire();
+  if (snapshot->isEmpty()) {
     std::cout << "\nIndex is empty.\n";
     return;
   }
   char sectionChar = getSectionChar();
   int sectionIndex = getSectionIndexFromChar(sectionChar);
-  index.displaySection(sectionIndex);
+  snapshot->displaySection(sectionIndex);
+}
+
+// Process: Boolean query over line numbers
+void IndexerUI::processBooleanQuery() {
+  VersionedIndex::snapshot_type snapshot = index.acquire();
+  if (snapshot->isEmpty()) {
+    std::cout << "\nIndex is empty.\n";
+    return;
+  }
+  std::string query = getQueryString();
+  if (query.empty()) return;
+
+  try {
+    QueryEngine engine(*snapshot);
+    std::vector<Indexer::line_type> lines = engine.evaluate(query);
+    if (lines.empty()) {
+      std::cout << "No matching lines.\n";
+      // Single unknown token: offer the closest indexed spelling
+      if (query.find_first_of(" \t()\"*?") == std::string::npos && snapshot->findToken(query) == nullptr) {
+        const IndexedToken* suggestion = snapshot->suggestToken(query);
+        if (suggestion != nullptr) {
+          std::cout << "Did you mean '" << suggestion->getToken() << "'?\n";
+        }
+      }
+      return;
+    }
+    std::cout << "Matching lines (" << lines.size() << "):";
+    for (auto it = lines.cbegin(); it != lines.cend(); ++it) {
+      std::cout << " " << *it;
+    }
+    std::cout << std::endl;
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "Invalid query: " << e.what() << std::endl;
+  }
+}
+
+// Process: Run a file of queries on worker threads
+void IndexerUI::processBatchQueries() {
+  VersionedIndex::snapshot_type snapshot = index.acquire();
+  if (snapshot->isEmpty()) {
+    std::cout << "\nIndex is empty.\n";
+    return;
+  }
+  std::string queryFile;
+  std::cout << "Enter the query file (token/length/section/query per line): ";
+  if (!std::getline(std::cin, queryFile) || queryFile.empty()) {
+    std::cerr << "Error: Invalid filename input.\n";
+    return;
+  }
+  std::string outputFile;
+  std::cout << "Enter the output file (blank for screen): ";
+  std::getline(std::cin, outputFile);
+
+  BatchQueryRunner runner(*snapshot);
+  runner.loadFile(queryFile);
+
+  BatchQueryRunner::Stats stats;
+  if (outputFile.empty()) {
+    stats = runner.run(std::cout);
+  } else {
+    std::ofstream out(outputFile);
+    if (!out.is_open()) {
+      std::cerr << "Error: Could not open output file " << outputFile << std::endl;
+      return;
+    }
+    stats = runner.run(out);
+  }
+
+  auto micros = [](std::chrono::nanoseconds ns) { return ns.count() / 1000.0; };
+  std::cout << stats.queries << " queries on " << stats.threads << " threads in "
+            << micros(stats.wallTime) / 1000.0 << " ms (" << stats.queriesPerSecond
+            << " queries/sec, p50 " << micros(stats.p50) << " us, p99 "
+            << micros(stats.p99) << " us)" << std::endl;
+}
+
+// Process: Write the index in a machine-readable format
+void IndexerUI::processExport() {
+  VersionedIndex::snapshot_type snapshot = index.acquire();
+  if (snapshot->isEmpty()) {
+    std::cout << "\nIndex is empty.\n";
+    return;
+  }
+  std::string formatName;
+  std::cout << "Enter export format (jsonl, csv, bin): ";
+  std::getline(std::cin, formatName);
+  ExportFormat format;
+  try {
+    format = parseExportFormat(formatName);
+  } catch (const std::invalid_argument& e) {
+    std::cerr << "Error: " << e.what() << std::endl;
+    return;
+  }
+
+  std::string outputFile;
+  std::cout << "Enter the output file: ";
+  if (!std::getline(std::cin, outputFile) || outputFile.empty()) {
+    std::cerr << "Error: Invalid filename input.\n";
+    return;
+  }
+  IndexExporter(*snapshot).writeFile(outputFile, format);
+  std::cout << "Index exported to " << outputFile << std::endl;
+}
+
+// Process: Save the index in the binary index format
+void IndexerUI::processSaveIndex() {
+  VersionedIndex::snapshot_type snapshot = index.acquire();
+  if (snapshot->isEmpty()) {
+    std::cout << "\nIndex is empty.\n";
+    return;
+  }
+  std::string path;
+  std::cout << "Enter the index file to write: ";
+  if (!std::getline(std::cin, path) || path.empty()) {
+    std::cerr << "Error: Invalid filename input.\n";
+    return;
+  }
+  snapshot->save(path);
+  std::cout << "Index saved to " << path << std::endl;
+}
+
+// Process: Replace the index with a saved one
+void IndexerUI::processLoadIndex() {
+  if (!index.acquire()->isEmpty()) {
+    std::cout << "Index is not empty. Replace existing index?";
+    char confirm = getConfirmation();
+    if (confirm != 'y') {
+      std::cout << "Loading cancelled.\n";
+      return;
+    }
+  }
+  std::string path;
+  std::cout << "Enter the index file to load: ";
+  if (!std::getline(std::cin, path) || path.empty()) {
+    std::cerr << "Error: Invalid filename input.\n";
+    return;
+  }
+  index.rebuild([&path](Indexer& next) { next.load(path); });
+  VersionedIndex::snapshot_type loaded = index.acquire();
+  std::cout << "Index loaded from " << path << " (" << loaded->getLineCount() << " lines, "
+            << loaded->getTokenCount() << " tokens)." << std::endl;
 }
 
 // Helper maps valid browse char ('A'-'Z', '*') to index 0-26
@@ -2,15 +2,17 @@
 #define INDEXERUI_H
 
 #include "../Indexer/Indexer.h"
+#include "../VersionedIndex/VersionedIndex.h"
 #include <string>
 #include <limits>
 
 // Main application class.
 class IndexerUI {
 private:
-    Indexer index;          // The index 
+    VersionedIndex index;   // Published versions of the index
     std::string currentFilename;  // Name of the currently indexed file.
     static constexpr auto max_stream_size = std::numeric_limits<std::streamsize>::max();
+    static constexpr int EXIT_CHOICE = 10;  // Last menu entry
 
     // UI Helpers
     void displayMenu() const;
@@ -19,12 +21,20 @@ private:
     size_t getSearchLength() const; // Robust length input.
     char getSectionChar() const;    // Robust section character input.
     std::string getFileName() const;    // Robust file name query.
+    std::string getQueryString() const; // Robust boolean query input.
 
     // Processing Helpers
     void processIndexFile();
     void processDisplayAll();
     void processShowByLength();
     void processViewSection();
+    void processBooleanQuery();
+    void processBatchQueries();
+    void processExport();
+    void processSaveIndex();
+    void processLoadIndex();
+
+    static Indexer positionalIndex();
 
     // Utility Helper
     int getSectionIndexFromChar(char firstChar) const; // Maps char to section.
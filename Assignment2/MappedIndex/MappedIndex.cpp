@@ -0,0 +1,317 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "MappedIndex.h"
+#include <cerrno>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../Indexer/Indexer.h"
+
+// EntryView
+MappedIndex::EntryView::EntryView(const MappedIndex& owner, const IndexFile::Entry& entry, std::string key)
+    : owner(&owner), entry(&entry), key(std::move(key)) {}
+
+std::string_view MappedIndex::EntryView::getToken() const {
+    if (entry->tokenLength == 0) return key;
+    return std::string_view(owner->base + owner->header->strings.offset + entry->stringsOffset, entry->tokenLength);
+}
+
+const std::string& MappedIndex::EntryView::getKey() const {
+    return key;
+}
+
+// Forms follow the token as (u32 length, bytes); a form running past the strings region ends the list
+std::vector<std::string_view> MappedIndex::EntryView::getSurfaceForms() const {
+    std::vector<std::string_view> forms;
+    std::uint64_t offset = entry->stringsOffset + entry->tokenLength;
+    const std::uint64_t end = owner->header->strings.size;
+    const char* strings = owner->base + owner->header->strings.offset;
+    for (std::uint32_t i = 0; i < entry->formCount; ++i) {
+        std::uint32_t length = 0;
+        if (end - offset < sizeof(length)) break;
+        std::memcpy(&length, strings + offset, sizeof(length));
+        offset += sizeof(length);
+        if (end - offset < length) break;
+        forms.emplace_back(strings + offset, length);
+        offset += length;
+    }
+    return forms;
+}
+
+size_t MappedIndex::EntryView::postingCount() const {
+    return entry->postingsCount;
+}
+
+std::uint64_t MappedIndex::EntryView::lineAt(size_t i) const {
+    const char* postings = owner->base + owner->header->postings.offset;
+    if (owner->header->lineWidth == sizeof(std::uint32_t)) {
+        return reinterpret_cast<const std::uint32_t*>(postings)[entry->postingsOffset + i];
+    }
+    return reinterpret_cast<const std::uint64_t*>(postings)[entry->postingsOffset + i];
+}
+
+void MappedIndex::EntryView::print(BufferedWriter& out) const {
+    out << getToken();
+    if (entry->formCount != 0) {
+        std::vector<std::string_view> forms = getSurfaceForms();
+        out << " (";
+        for (auto it = forms.cbegin(); it != forms.cend(); ++it) {
+            if (it != forms.cbegin()) {
+                out << ", ";
+            }
+            out << *it;
+        }
+        out << ')';
+    }
+    out << ' ';
+
+    // Postings are written straight from the mapping
+    const char* postings = owner->base + owner->header->postings.offset;
+    if (owner->header->lineWidth == sizeof(std::uint32_t)) {
+        const auto* lines = reinterpret_cast<const std::uint32_t*>(postings) + entry->postingsOffset;
+        out.writeNumbers(std::span<const std::uint32_t>(lines, entry->postingsCount));
+    } else {
+        const auto* lines = reinterpret_cast<const std::uint64_t*>(postings) + entry->postingsOffset;
+        out.writeNumbers(std::span<const std::uint64_t>(lines, entry->postingsCount));
+    }
+}
+
+// Constructor - maps the whole file read-only
+MappedIndex::MappedIndex(const std::string& path, IndexFile::Verify level) : path(path) {
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw std::runtime_error("Could not open index file '" + path + "': " + std::strerror(errno));
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0) {
+        int error = errno;
+        ::close(fd);
+        throw std::runtime_error("Could not stat index file '" + path + "': " + std::strerror(error));
+    }
+    size = static_cast<size_t>(info.st_size);
+    if (size == 0) {
+        ::close(fd);
+        throw std::runtime_error("Invalid index file '" + path + "': too short for a header");
+    }
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+    int error = errno;
+    ::close(fd);  // the mapping keeps the file referenced
+    if (mapping == MAP_FAILED) {
+        throw std::runtime_error("Could not map index file '" + path + "': " + std::strerror(error));
+    }
+    base = static_cast<const char*>(mapping);
+
+    try {
+        header = &IndexFile::validate(base, size, path, level);
+    } catch (...) {
+        unmap();
+        throw;
+    }
+    sections = reinterpret_cast<const IndexFile::Section*>(base + header->directory.offset);
+    entries = reinterpret_cast<const IndexFile::Entry*>(base + header->entries.offset);
+    for (size_t i = 0; i < dictionaries.size(); ++i) {
+        dictionaries[i] = IndexFile::sectionDictionary(base, *header, sections[i]);
+    }
+}
+
+// Move constructor
+MappedIndex::MappedIndex(MappedIndex&& other) noexcept
+    : base(other.base), size(other.size), header(other.header), sections(other.sections),
+      entries(other.entries), dictionaries(std::move(other.dictionaries)), path(std::move(other.path)) {
+    other.base = nullptr;
+    other.size = 0;
+}
+
+// Move assignment operator
+MappedIndex& MappedIndex::operator=(MappedIndex&& other) noexcept {
+    if (this != &other) {
+        unmap();
+        base = other.base;
+        size = other.size;
+        header = other.header;
+        sections = other.sections;
+        entries = other.entries;
+        dictionaries = std::move(other.dictionaries);
+        path = std::move(other.path);
+        other.base = nullptr;
+        other.size = 0;
+    }
+    return *this;
+}
+
+// Destructor
+MappedIndex::~MappedIndex() {
+    unmap();
+}
+
+void MappedIndex::unmap() {
+    if (base != nullptr) {
+        ::munmap(const_cast<char*>(base), size);
+        base = nullptr;
+    }
+}
+
+const IndexFile::Entry& MappedIndex::entryAt(std::uint64_t i) const {
+    const IndexFile::Entry& entry = entries[i];
+    if (!IndexFile::entryInBounds(*header, entry)) {
+        throw std::runtime_error("Invalid index file '" + path + "': entry " + std::to_string(i) +
+                                 " refers outside its region");
+    }
+    return entry;
+}
+
+std::uint64_t MappedIndex::tokenLength(const IndexFile::Entry& entry) {
+    return entry.tokenLength != 0 ? entry.tokenLength : entry.keyLength;
+}
+
+template <typename Visit>
+void MappedIndex::forEachInSection(int sectionIndex, Visit visit) const {
+    const IndexFile::Section& section = sections[sectionIndex];
+    FrontCodedDictionary::Cursor keys = dictionaries[sectionIndex].cursor();
+    for (std::uint64_t e = section.firstEntry; e < section.firstEntry + section.entryCount; ++e) {
+        visit(EntryView(*this, entryAt(e), keys.next()));
+    }
+}
+
+bool MappedIndex::isEmpty() const {
+    return header->entryCount == 0;
+}
+
+bool MappedIndex::isPositional() const {
+    return (header->flags & IndexFile::FLAG_POSITIONAL) != 0;
+}
+
+bool MappedIndex::isCaseInsensitive() const {
+    return (header->flags & IndexFile::FLAG_CASE_INSENSITIVE) != 0;
+}
+
+std::uint64_t MappedIndex::getLineCount() const {
+    return header->lineCount;
+}
+
+std::uint64_t MappedIndex::getTokenCount() const {
+    return header->tokenCount;
+}
+
+std::uint64_t MappedIndex::getEntryCount() const {
+    return header->entryCount;
+}
+
+std::string_view MappedIndex::getFilename() const {
+    return std::string_view(base + header->filename.offset, header->filename.size);
+}
+
+// The dictionary's position of the key is the entry's position within its section
+std::optional<MappedIndex::EntryView> MappedIndex::findToken(std::string_view token) const {
+    if (token.empty()) return std::nullopt;
+    std::string key = isCaseInsensitive() ? foldCase(token) : std::string(token);
+    int sectionIndex = getSectionIndex(key[0]);
+    std::optional<size_t> ordinal = dictionaries[sectionIndex].find(key);
+    if (!ordinal) return std::nullopt;
+    return EntryView(*this, entryAt(sections[sectionIndex].firstEntry + *ordinal), std::move(key));
+}
+
+std::vector<MappedIndex::EntryView> MappedIndex::findByLength(size_t length) const {
+    std::vector<EntryView> result;
+    for (int i = 0; i < NUM_SECTIONS; ++i) {
+        for (std::uint64_t e = sections[i].firstEntry; e < sections[i].firstEntry + sections[i].entryCount; ++e) {
+            if (tokenLength(entries[e]) == length) {
+                result.emplace_back(*this, entryAt(e), dictionaries[i].at(e - sections[i].firstEntry));
+            }
+        }
+    }
+    return result;
+}
+
+// Displays the entire index
+void MappedIndex::print(std::ostream& os) const {
+    BufferedWriter out(os);
+    if (header->filename.size != 0) {
+        out << "Index for file: " << getFilename() << '\n';
+        out << "================================" << '\n';
+    }
+    for (int i = 0; i < NUM_SECTIONS; ++i) {
+        if (sections[i].entryCount == 0) continue;
+        if (i < 26) {
+            out << "--- Section " << static_cast<char>('A' + i) << " ---" << '\n';
+        } else {
+            out << "--- Section [Non-alphabetic] ---" << '\n';
+        }
+        forEachInSection(i, [&out](const EntryView& entry) {
+            entry.print(out);
+            out << '\n';
+        });
+        out << '\n';
+    }
+    out.flush();
+}
+
+void MappedIndex::renderSection(int sectionIndex, BufferedWriter& out) const {
+    if (sectionIndex < 0 || sectionIndex >= NUM_SECTIONS) {
+        out << "Invalid section index: " << sectionIndex << '\n';
+        return;
+    }
+    const IndexFile::Section& section = sections[sectionIndex];
+    if (section.entryCount == 0) {
+        if (sectionIndex < NUM_SECTIONS - 1) {
+            out << "Section " << static_cast<char>('A' + sectionIndex) << " is empty." << '\n';
+        } else {
+            out << "Section [Non-alphabetic] is empty." << '\n';
+        }
+        return;
+    }
+    if (sectionIndex < NUM_SECTIONS - 1) {
+        out << "--- Section " << static_cast<char>('A' + sectionIndex) << " ---" << '\n';
+    } else {
+        out << "--- Section [Non-alphabetic] ---" << '\n';
+    }
+    forEachInSection(sectionIndex, [&out](const EntryView& entry) {
+        entry.print(out);
+        out << '\n';
+    });
+}
+
+void MappedIndex::displaySection(int sectionIndex, std::ostream& os) const {
+    BufferedWriter out(os);
+    renderSection(sectionIndex, out);
+    out.flush();
+}
+
+void MappedIndex::listByLength(size_t length, std::ostream& os) const {
+    BufferedWriter out(os);
+    out << "Tokens of length " << length << ":" << '\n';
+
+    bool found = false;
+    for (int i = 0; i < NUM_SECTIONS; ++i) {
+        bool sectionStarted = false;
+        for (std::uint64_t e = sections[i].firstEntry; e < sections[i].firstEntry + sections[i].entryCount; ++e) {
+            if (tokenLength(entries[e]) != length) continue;
+            if (!sectionStarted) {
+                if (found) {
+                    out << '\n';  // Add spacing between sections
+                }
+                if (i < NUM_SECTIONS - 1) {
+                    out << "--- Section " << static_cast<char>('A' + i) << " ---" << '\n';
+                } else {
+                    out << "--- Section [Non-alphabetic] ---" << '\n';
+                }
+                sectionStarted = true;
+                found = true;
+            }
+            // Matches are sparse, so each decodes its key from its block head
+            EntryView(*this, entryAt(e), dictionaries[i].at(e - sections[i].firstEntry)).print(out);
+            out << '\n';
+        }
+    }
+    if (!found) {
+        out << "No tokens of length " << length << " found." << '\n';
+    }
+    out.flush();
+}
@@ -0,0 +1,112 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Read-only index served in place from a memory-mapped index file
+//
+
+#ifndef MAPPED_INDEX_H
+#define MAPPED_INDEX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../BufferedWriter/BufferedWriter.h"
+#include "../IndexFile/IndexFile.h"
+
+/**
+ * @class MappedIndex
+ * @brief Queries a file written by Indexer::save without loading it.
+ *
+ * The file is mapped read-only and every lookup reads the mapping directly:
+ * opening costs a constant-time layout check, no entry is copied, and the pages
+ * are shared (through the page cache) by every process serving the same file.
+ * Keys are decoded from the front-coded section dictionaries as they are needed.
+ * Output of the display functions is byte-identical to the Indexer's.
+ * Works with files of either line width. Linux / POSIX only.
+ */
+class MappedIndex {
+public:
+    static const int NUM_SECTIONS = static_cast<int>(IndexFile::SECTION_COUNT);
+
+    /**
+     * @class EntryView
+     * @brief One entry of the mapping with its decoded key; valid while the MappedIndex is open
+     */
+    class EntryView {
+    private:
+        const MappedIndex* owner;
+        const IndexFile::Entry* entry;
+        std::string key;
+
+    public:
+        EntryView(const MappedIndex& owner, const IndexFile::Entry& entry, std::string key);
+
+        // May view this object's key, so it is valid only as long as the view itself
+        std::string_view getToken() const;
+        const std::string& getKey() const;
+        std::vector<std::string_view> getSurfaceForms() const;
+        size_t postingCount() const;
+        std::uint64_t lineAt(size_t i) const;
+        // Same text as IndexedToken::print
+        void print(BufferedWriter& out) const;
+    };
+
+private:
+    const char* base = nullptr;  // Start of the mapping
+    size_t size = 0;
+    const IndexFile::Header* header = nullptr;
+    const IndexFile::Section* sections = nullptr;
+    const IndexFile::Entry* entries = nullptr;
+    std::array<FrontCodedDictionary, IndexFile::SECTION_COUNT> dictionaries;  // Keys, viewed in the mapping
+    std::string path;
+
+    void unmap();
+    const IndexFile::Entry& entryAt(std::uint64_t i) const;  // bounds-checked
+    // Length of an entry's token (its key's unless a display spelling is stored)
+    static std::uint64_t tokenLength(const IndexFile::Entry& entry);
+    // Entries of a section in order, each with its key decoded in sequence
+    template <typename Visit>
+    void forEachInSection(int sectionIndex, Visit visit) const;
+    void renderSection(int sectionIndex, BufferedWriter& out) const;
+
+public:
+    /**
+     * @brief Map an index file. Verify::Layout (the default) keeps opening constant
+     * time and checks each entry when it is read; Verify::Full also checks every
+     * checksum up front. Throws std::runtime_error if the file cannot be mapped or is invalid.
+     */
+    explicit MappedIndex(const std::string& path, IndexFile::Verify level = IndexFile::Verify::Layout);
+
+    // The mapping has a single owner
+    MappedIndex(const MappedIndex& other) = delete;
+    MappedIndex& operator=(const MappedIndex& other) = delete;
+    MappedIndex(MappedIndex&& other) noexcept;
+    MappedIndex& operator=(MappedIndex&& other) noexcept;
+
+    ~MappedIndex();
+
+    bool isEmpty() const;
+    bool isPositional() const;
+    bool isCaseInsensitive() const;
+    std::uint64_t getLineCount() const;
+    std::uint64_t getTokenCount() const;
+    std::uint64_t getEntryCount() const;
+    std::string_view getFilename() const;  // Text file the index was built from
+
+    // Binary search over the block heads of the token's section dictionary, then a
+    // scan of one block (folded in case-insensitive files)
+    std::optional<EntryView> findToken(std::string_view token) const;
+    // Entries with a token of the given length, in index order (scans the entry table)
+    std::vector<EntryView> findByLength(size_t length) const;
+
+    // Display functions, same output as the Indexer's
+    void print(std::ostream& os = std::cout) const;
+    void displaySection(int sectionIndex, std::ostream& os = std::cout) const;
+    void listByLength(size_t length, std::ostream& os = std::cout) const;
+};
+
+#endif // MAPPED_INDEX_H
@@ -0,0 +1,165 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "PostingOps.h"
+#include <algorithm>
+#include <iterator>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define POSTING_OPS_SSE2 1
+#endif
+
+namespace {
+
+    // Lists whose sizes differ by more than this factor are intersected by galloping
+    constexpr size_t GALLOP_RATIO = 32;
+
+    // First position in [first, last) whose value is >= target; exponential probe then binary search
+    template <typename LineT>
+    const LineT* gallop(const LineT* first, const LineT* last, LineT target) {
+        size_t step = 1;
+        const LineT* probe = first;
+        while (probe < last && *probe < target) {
+            first = probe + 1;
+            probe = (static_cast<size_t>(last - probe) > step) ? probe + step : last;
+            step *= 2;
+        }
+        return std::lower_bound(first, probe, target);
+    }
+
+    template <typename LineT>
+    void intersectGalloping(std::span<const LineT> small, std::span<const LineT> large, std::vector<LineT>& out) {
+        const LineT* cursor = large.data();
+        const LineT* end = large.data() + large.size();
+        for (LineT line : small) {
+            cursor = gallop(cursor, end, line);
+            if (cursor == end) break;
+            if (*cursor == line) {
+                out.push_back(line);
+                ++cursor;
+            }
+        }
+    }
+
+    template <typename LineT>
+    void intersectMerge(const LineT* a, const LineT* aEnd, const LineT* b, const LineT* bEnd, std::vector<LineT>& out) {
+        while (a != aEnd && b != bEnd) {
+            if (*a < *b) {
+                ++a;
+            } else if (*b < *a) {
+                ++b;
+            } else {
+                out.push_back(*a);
+                ++a;
+                ++b;
+            }
+        }
+    }
+
+    template <typename LineT>
+    void intersectLinear(std::span<const LineT> a, std::span<const LineT> b, std::vector<LineT>& out) {
+        intersectMerge(a.data(), a.data() + a.size(), b.data(), b.data() + b.size(), out);
+    }
+
+#ifdef POSTING_OPS_SSE2
+    // Compares blocks of four against all four rotations of the other block,
+    // then advances whichever block has the smaller maximum
+    template <>
+    void intersectLinear<std::uint32_t>(std::span<const std::uint32_t> a, std::span<const std::uint32_t> b,
+                                        std::vector<std::uint32_t>& out) {
+        const std::uint32_t* pa = a.data();
+        const std::uint32_t* pb = b.data();
+        const std::uint32_t* aEnd = pa + a.size();
+        const std::uint32_t* bEnd = pb + b.size();
+
+        while (aEnd - pa >= 4 && bEnd - pb >= 4) {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pa));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pb));
+            __m128i match = _mm_or_si128(
+                _mm_or_si128(_mm_cmpeq_epi32(va, vb),
+                             _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+                _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                             _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+            int mask = _mm_movemask_ps(_mm_castsi128_ps(match));
+            for (int lane = 0; lane < 4; ++lane) {
+                if (mask & (1 << lane)) {
+                    out.push_back(pa[lane]);
+                }
+            }
+
+            std::uint32_t aMax = pa[3];
+            std::uint32_t bMax = pb[3];
+            if (aMax <= bMax) pa += 4;
+            if (bMax <= aMax) pb += 4;
+        }
+        intersectMerge(pa, aEnd, pb, bEnd, out);
+    }
+#endif
+
+} // namespace
+
+template <typename LineT>
+std::vector<LineT> uniqueLines(std::span<const LineT> lines) {
+    std::vector<LineT> result;
+    result.reserve(lines.size());
+    std::unique_copy(lines.begin(), lines.end(), std::back_inserter(result));
+    return result;
+}
+
+template <typename LineT>
+std::vector<LineT> intersectLines(std::span<const LineT> a, std::span<const LineT> b) {
+    std::vector<LineT> result;
+    if (a.empty() || b.empty()) return result;
+    if (a.size() > b.size()) std::swap(a, b);
+
+    result.reserve(a.size());
+    if (b.size() / a.size() > GALLOP_RATIO) {
+        intersectGalloping(a, b, result);
+    } else {
+        intersectLinear(a, b, result);
+    }
+    return result;
+}
+
+template <typename LineT>
+std::vector<LineT> uniteLines(std::span<const LineT> a, std::span<const LineT> b) {
+    std::vector<LineT> result;
+    result.reserve(a.size() + b.size());
+    std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return result;
+}
+
+template <typename LineT>
+std::vector<LineT> subtractLines(std::span<const LineT> a, std::span<const LineT> b) {
+    std::vector<LineT> result;
+    result.reserve(a.size());
+    std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(result));
+    return result;
+}
+
+template <typename LineT>
+std::vector<LineT> complementLines(std::span<const LineT> a, LineT lineCount) {
+    std::vector<LineT> result;
+    auto it = a.begin();
+    for (LineT line = 1; line <= lineCount && line != 0; ++line) {
+        if (it != a.end() && *it == line) {
+            ++it;
+        } else {
+            result.push_back(line);
+        }
+    }
+    return result;
+}
+
+// Explicit instantiations for the supported posting widths
+#define POSTING_OPS_INSTANTIATE(LineT) \
+    template std::vector<LineT> uniqueLines<LineT>(std::span<const LineT>); \
+    template std::vector<LineT> intersectLines<LineT>(std::span<const LineT>, std::span<const LineT>); \
+    template std::vector<LineT> uniteLines<LineT>(std::span<const LineT>, std::span<const LineT>); \
+    template std::vector<LineT> subtractLines<LineT>(std::span<const LineT>, std::span<const LineT>); \
+    template std::vector<LineT> complementLines<LineT>(std::span<const LineT>, LineT);
+
+POSTING_OPS_INSTANTIATE(std::uint32_t)
+POSTING_OPS_INSTANTIATE(std::uint64_t)
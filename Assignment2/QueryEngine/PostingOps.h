@@ -0,0 +1,46 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Set operations over sorted, duplicate-free line number lists
+//
+
+#ifndef POSTING_OPS_H
+#define POSTING_OPS_H
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief Sorted, duplicate-free copy of a postings list
+ * (a token used twice on one line appears once)
+ */
+template <typename LineT>
+std::vector<LineT> uniqueLines(std::span<const LineT> lines);
+
+/**
+ * @brief Lines present in both a and b.
+ * Uses galloping search when one list is much shorter than the other,
+ * otherwise a linear merge (SSE2 block compare for 32-bit lines where available).
+ */
+template <typename LineT>
+std::vector<LineT> intersectLines(std::span<const LineT> a, std::span<const LineT> b);
+
+/**
+ * @brief Lines present in a or b
+ */
+template <typename LineT>
+std::vector<LineT> uniteLines(std::span<const LineT> a, std::span<const LineT> b);
+
+/**
+ * @brief Lines present in a but not in b
+ */
+template <typename LineT>
+std::vector<LineT> subtractLines(std::span<const LineT> a, std::span<const LineT> b);
+
+/**
+ * @brief Lines 1..lineCount not present in a
+ */
+template <typename LineT>
+std::vector<LineT> complementLines(std::span<const LineT> a, LineT lineCount);
+
+#endif // POSTING_OPS_H
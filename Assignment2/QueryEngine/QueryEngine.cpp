@@ -0,0 +1,373 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "QueryEngine.h"
+#include "PostingOps.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+    // Split a query into words; parentheses are words of their own and a
+    // quoted phrase is kept as one word, including its opening quote
+    std::vector<std::string> splitQuery(const std::string& expression) {
+        std::vector<std::string> words;
+        std::string current;
+        for (size_t i = 0; i < expression.size(); ++i) {
+            char c = expression[i];
+            if (c == '"' && current.empty()) {
+                size_t close = expression.find('"', i + 1);
+                if (close == std::string::npos) {
+                    throw std::invalid_argument("missing closing quote in query");
+                }
+                words.push_back(expression.substr(i, close - i));
+                i = close;
+            } else if (std::isspace(static_cast<unsigned char>(c)) || c == '(' || c == ')') {
+                if (!current.empty()) {
+                    words.push_back(current);
+                    current.clear();
+                }
+                if (c == '(' || c == ')') {
+                    words.emplace_back(1, c);
+                }
+            } else {
+                current += c;
+            }
+        }
+        if (!current.empty()) {
+            words.push_back(current);
+        }
+        return words;
+    }
+
+    // NEAR/k operator; distance receives k. Throws std::invalid_argument if k
+    // does not fit in a word position.
+    template <typename PositionT>
+    bool parseNear(const std::string& word, PositionT& distance) {
+        const std::string prefix = "NEAR/";
+        if (word.compare(0, prefix.size(), prefix) != 0 || word.size() == prefix.size()) return false;
+        if (word.find_first_not_of("0123456789", prefix.size()) != std::string::npos) return false;
+
+        const PositionT max = std::numeric_limits<PositionT>::max();
+        PositionT value = 0;
+        for (size_t i = prefix.size(); i < word.size(); ++i) {
+            PositionT digit = static_cast<PositionT>(word[i] - '0');
+            if (value > (max - digit) / 10) {
+                throw std::invalid_argument("NEAR distance in '" + word + "' is too large");
+            }
+            value = value * 10 + digit;
+        }
+        distance = value;
+        return true;
+    }
+
+    bool isOperator(const std::string& word) {
+        std::uint32_t distance;
+        return word == "AND" || word == "OR" || word == "NOT" || word == "(" || word == ")" ||
+               parseNear(word, distance);
+    }
+
+    // Moves a cursor to the first (line, position) at or after the target pair
+    template <typename Cursor, typename LineT, typename PositionT>
+    void advanceTo(Cursor& cursor, LineT line, PositionT position) {
+        while (cursor.valid() && (cursor.line() < line || (cursor.line() == line && cursor.position() < position))) {
+            cursor.next();
+        }
+    }
+
+} // namespace
+
+// Constructor
+template <typename Traits>
+BasicQueryEngine<Traits>::BasicQueryEngine(const indexer_type& indexer) : indexer(indexer) {}
+
+// Parse and evaluate a single expression
+template <typename Traits>
+typename BasicQueryEngine<Traits>::result_type BasicQueryEngine<Traits>::evaluate(const std::string& expression) const {
+    std::vector<std::string> words = splitQuery(expression);
+    if (words.empty()) {
+        throw std::invalid_argument("empty query");
+    }
+
+    size_t pos = 0;
+    std::unique_ptr<Node> root = parseOr(words, pos);
+    if (pos != words.size()) {
+        throw std::invalid_argument("unexpected '" + words[pos] + "' in query");
+    }
+    return evaluate(*root);
+}
+
+// Evaluate several expressions in input order
+template <typename Traits>
+std::vector<typename BasicQueryEngine<Traits>::result_type>
+BasicQueryEngine<Traits>::evaluateBatch(const std::vector<std::string>& expressions) const {
+    std::vector<result_type> results;
+    results.reserve(expressions.size());
+    for (auto it = expressions.cbegin(); it != expressions.cend(); ++it) {
+        results.push_back(evaluate(*it));
+    }
+    return results;
+}
+
+// expr := andExpr ( OR andExpr )*
+template <typename Traits>
+std::unique_ptr<typename BasicQueryEngine<Traits>::Node>
+BasicQueryEngine<Traits>::parseOr(const std::vector<std::string>& words, size_t& pos) const {
+    std::unique_ptr<Node> first = parseAnd(words, pos);
+    if (pos >= words.size() || words[pos] != "OR") return first;
+
+    auto node = std::make_unique<Node>();
+    node->kind = Node::Kind::Or;
+    node->children.push_back(std::move(first));
+    while (pos < words.size() && words[pos] == "OR") {
+        ++pos;
+        node->children.push_back(parseAnd(words, pos));
+    }
+    return node;
+}
+
+// andExpr := notExpr ( [AND] notExpr )*
+template <typename Traits>
+std::unique_ptr<typename BasicQueryEngine<Traits>::Node>
+BasicQueryEngine<Traits>::parseAnd(const std::vector<std::string>& words, size_t& pos) const {
+    std::unique_ptr<Node> first = parseNot(words, pos);
+
+    auto node = std::make_unique<Node>();
+    node->kind = Node::Kind::And;
+    node->children.push_back(std::move(first));
+    while (pos < words.size() && words[pos] != "OR" && words[pos] != ")") {
+        if (words[pos] == "AND") ++pos;  // explicit AND is optional
+        node->children.push_back(parseNot(words, pos));
+    }
+
+    if (node->children.size() == 1) return std::move(node->children.front());
+    return node;
+}
+
+// notExpr := NOT notExpr | '(' expr ')' | "phrase words" | token [ NEAR/k token ]
+template <typename Traits>
+std::unique_ptr<typename BasicQueryEngine<Traits>::Node>
+BasicQueryEngine<Traits>::parseNot(const std::vector<std::string>& words, size_t& pos) const {
+    if (pos >= words.size()) {
+        throw std::invalid_argument("query ends where a token was expected");
+    }
+
+    const std::string& word = words[pos];
+    if (word == "NOT") {
+        ++pos;
+        auto node = std::make_unique<Node>();
+        node->kind = Node::Kind::Not;
+        node->children.push_back(parseNot(words, pos));
+        return node;
+    }
+    if (word == "(") {
+        ++pos;
+        std::unique_ptr<Node> inner = parseOr(words, pos);
+        if (pos >= words.size() || words[pos] != ")") {
+            throw std::invalid_argument("missing ')' in query");
+        }
+        ++pos;
+        return inner;
+    }
+    if (word.front() == '"') {
+        // Quoted phrase: split the inner words
+        auto node = std::make_unique<Node>();
+        node->kind = Node::Kind::Phrase;
+        std::istringstream inner(word.substr(1));
+        std::string term;
+        while (inner >> term) {
+            node->terms.push_back(term);
+        }
+        if (node->terms.empty()) {
+            throw std::invalid_argument("empty phrase in query");
+        }
+        ++pos;
+        return node;
+    }
+    if (isOperator(word)) {
+        throw std::invalid_argument("unexpected '" + word + "' in query");
+    }
+
+    auto node = std::make_unique<Node>();
+    node->kind = Node::Kind::Term;
+    node->term = word;
+    ++pos;
+
+    // token NEAR/k token
+    position_type distance = 0;
+    if (pos < words.size() && parseNear(words[pos], distance)) {
+        ++pos;
+        if (pos >= words.size() || isOperator(words[pos]) || words[pos].front() == '"') {
+            throw std::invalid_argument("NEAR needs a token on both sides");
+        }
+        node->kind = Node::Kind::Near;
+        node->terms = {node->term, words[pos]};
+        node->distance = distance;
+        ++pos;
+    }
+    return node;
+}
+
+// Evaluate a subtree
+template <typename Traits>
+typename BasicQueryEngine<Traits>::result_type BasicQueryEngine<Traits>::evaluate(const Node& node) const {
+    switch (node.kind) {
+        case Node::Kind::Term:
+            return evaluateTerm(node.term);
+        case Node::Kind::And:
+            return evaluateAnd(node);
+        case Node::Kind::Or: {
+            result_type result = evaluate(*node.children.front());
+            for (size_t i = 1; i < node.children.size(); ++i) {
+                result_type next = evaluate(*node.children[i]);
+                result = uniteLines<line_type>(result, next);
+            }
+            return result;
+        }
+        case Node::Kind::Not: {
+            result_type inner = evaluate(*node.children.front());
+            return complementLines<line_type>(inner, static_cast<line_type>(indexer.getLineCount()));
+        }
+        case Node::Kind::Phrase:
+            return evaluatePhrase(node.terms);
+        case Node::Kind::Near:
+            return evaluateNear(node.terms[0], node.terms[1], node.distance);
+    }
+    return {};
+}
+
+// Lines on which a token occurs
+template <typename Traits>
+typename BasicQueryEngine<Traits>::result_type BasicQueryEngine<Traits>::evaluateTerm(const std::string& term) const {
+    if (term.find_first_of("*?") != std::string::npos) {
+        // Wildcard term: lines of any matching token
+        result_type result;
+        auto matches = indexer.findWildcard(term);
+        for (auto it = matches.cbegin(); it != matches.cend(); ++it) {
+            const auto& lines = (*it)->getLineNumbers();
+            result.insert(result.end(), lines.cbegin(), lines.cend());
+        }
+        std::sort(result.begin(), result.end());
+        result.erase(std::unique(result.begin(), result.end()), result.end());
+        return result;
+    }
+
+    const auto* token = indexer.findToken(term);
+    if (token == nullptr) return {};
+    return uniqueLines<line_type>(token->getLineNumbers());
+}
+
+// Lines containing the terms at consecutive positions.
+// The first term's cursor drives; every other cursor only moves forward to
+// (line, position + i), so each position list is decoded once.
+template <typename Traits>
+typename BasicQueryEngine<Traits>::result_type
+BasicQueryEngine<Traits>::evaluatePhrase(const std::vector<std::string>& terms) const {
+    if (terms.size() == 1) return evaluateTerm(terms.front());
+    if (!indexer.isPositional()) {
+        throw std::invalid_argument("phrase queries need a positional index");
+    }
+
+    std::vector<typename indexer_type::token_type::PositionCursor> cursors;
+    for (auto it = terms.cbegin(); it != terms.cend(); ++it) {
+        const auto* token = indexer.findToken(*it);
+        if (token == nullptr) return {};
+        cursors.push_back(token->positionCursor());
+    }
+
+    result_type result;
+    for (auto& lead = cursors.front(); lead.valid(); lead.next()) {
+        line_type line = lead.line();
+        position_type position = lead.position();
+        if (!result.empty() && result.back() == line) continue;  // line already matched
+
+        bool match = true;
+        for (size_t i = 1; i < cursors.size(); ++i) {
+            position_type target = position + static_cast<position_type>(i);
+            advanceTo(cursors[i], line, target);
+            if (!cursors[i].valid()) return result;  // no later match is possible
+            if (cursors[i].line() != line || cursors[i].position() != target) {
+                match = false;
+                break;
+            }
+        }
+        if (match) result.push_back(line);
+    }
+    return result;
+}
+
+// Lines where the two terms occur at most distance words apart
+template <typename Traits>
+typename BasicQueryEngine<Traits>::result_type
+BasicQueryEngine<Traits>::evaluateNear(const std::string& first, const std::string& second, position_type distance) const {
+    if (!indexer.isPositional()) {
+        throw std::invalid_argument("NEAR queries need a positional index");
+    }
+    const auto* a = indexer.findToken(first);
+    const auto* b = indexer.findToken(second);
+    if (a == nullptr || b == nullptr) return {};
+
+    result_type result;
+    auto other = b->positionCursor();
+    for (auto lead = a->positionCursor(); lead.valid(); lead.next()) {
+        line_type line = lead.line();
+        position_type position = lead.position();
+        if (!result.empty() && result.back() == line) continue;
+
+        // Earliest position of the other term that is still close enough
+        position_type low = position > distance ? position - distance : 0;
+        advanceTo(other, line, low);
+        if (!other.valid()) break;
+        // Saturating: a distance near the maximum must not wrap the upper bound
+        position_type high = distance > std::numeric_limits<position_type>::max() - position
+                                 ? std::numeric_limits<position_type>::max()
+                                 : position + distance;
+        if (other.line() == line && other.position() <= high) {
+            result.push_back(line);
+        }
+    }
+    return result;
+}
+
+// Intersect the positive operands smallest first, then subtract the negated ones
+template <typename Traits>
+typename BasicQueryEngine<Traits>::result_type BasicQueryEngine<Traits>::evaluateAnd(const Node& node) const {
+    std::vector<result_type> positive;
+    std::vector<result_type> negative;
+    for (auto it = node.children.cbegin(); it != node.children.cend(); ++it) {
+        if ((*it)->kind == Node::Kind::Not) {
+            negative.push_back(evaluate(*(*it)->children.front()));
+        } else {
+            positive.push_back(evaluate(**it));
+        }
+    }
+
+    result_type result;
+    if (positive.empty()) {
+        // Only negated operands: NOT a AND NOT b == NOT (a OR b)
+        for (auto it = negative.cbegin(); it != negative.cend(); ++it) {
+            result = uniteLines<line_type>(result, *it);
+        }
+        return complementLines<line_type>(result, static_cast<line_type>(indexer.getLineCount()));
+    }
+
+    std::sort(positive.begin(), positive.end(),
+              [](const result_type& a, const result_type& b) { return a.size() < b.size(); });
+    result = std::move(positive.front());
+    for (size_t i = 1; i < positive.size() && !result.empty(); ++i) {
+        result = intersectLines<line_type>(result, positive[i]);
+    }
+    for (auto it = negative.cbegin(); it != negative.cend() && !result.empty(); ++it) {
+        result = subtractLines<line_type>(result, *it);
+    }
+    return result;
+}
+
+// Explicit instantiations for the supported index widths
+template class BasicQueryEngine<CompactIndexTraits>;
+template class BasicQueryEngine<LargeIndexTraits>;
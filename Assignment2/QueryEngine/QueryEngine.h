@@ -0,0 +1,87 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Boolean queries (AND / OR / NOT) over the line postings of an Indexer
+//
+
+#ifndef QUERY_ENGINE_H
+#define QUERY_ENGINE_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "../Indexer/Indexer.h"
+
+/**
+ * @class BasicQueryEngine
+ * @brief Parses boolean expressions over tokens and evaluates them against
+ * a read-only index, returning the sorted matching line numbers.
+ *
+ * Grammar (keywords are upper case; adjacent terms are implicitly ANDed):
+ *   expr    := andExpr ( OR andExpr )*
+ *   andExpr := notExpr ( [AND] notExpr )*
+ *   notExpr := NOT notExpr | '(' expr ')' | "phrase words" | token [ NEAR/k token ]
+ *
+ * A token containing '*' or '?' matches every indexed token fitting the pattern.
+ * Phrases and NEAR/k (both tokens on one line, at most k words apart) need
+ * a positional index. Malformed expressions throw std::invalid_argument.
+ */
+template <typename Traits>
+class BasicQueryEngine {
+public:
+    using indexer_type = BasicIndexer<Traits>;
+    using line_type = typename indexer_type::line_type;
+    using position_type = typename indexer_type::position_type;
+    using result_type = std::vector<line_type>;
+
+private:
+    // Parsed expression tree
+    struct Node {
+        enum class Kind { Term, And, Or, Not, Phrase, Near };
+        Kind kind;
+        std::string term;                           // Kind::Term only
+        std::vector<std::string> terms;             // Kind::Phrase and Kind::Near
+        position_type distance = 0;                 // Kind::Near only
+        std::vector<std::unique_ptr<Node>> children;
+    };
+
+    const indexer_type& indexer;
+
+    // Recursive descent parser over the split query words
+    std::unique_ptr<Node> parseOr(const std::vector<std::string>& words, size_t& pos) const;
+    std::unique_ptr<Node> parseAnd(const std::vector<std::string>& words, size_t& pos) const;
+    std::unique_ptr<Node> parseNot(const std::vector<std::string>& words, size_t& pos) const;
+
+    // Evaluates a subtree to sorted, duplicate-free line numbers
+    result_type evaluate(const Node& node) const;
+    result_type evaluateTerm(const std::string& term) const;
+    result_type evaluateAnd(const Node& node) const;
+    result_type evaluatePhrase(const std::vector<std::string>& terms) const;
+    result_type evaluateNear(const std::string& first, const std::string& second, position_type distance) const;
+
+public:
+    // The engine only reads from the index; it must outlive the engine
+    explicit BasicQueryEngine(const indexer_type& indexer);
+
+    // Engines are cheap views over an index
+    BasicQueryEngine(const BasicQueryEngine& other) = default;
+    BasicQueryEngine& operator=(const BasicQueryEngine& other) = delete;
+    ~BasicQueryEngine() = default;
+
+    /**
+     * @brief Parse and evaluate a single expression
+     */
+    result_type evaluate(const std::string& expression) const;
+
+    /**
+     * @brief Evaluate several expressions; results are in input order
+     */
+    std::vector<result_type> evaluateBatch(const std::vector<std::string>& expressions) const;
+};
+
+using QueryEngine = BasicQueryEngine<CompactIndexTraits>;
+using LargeQueryEngine = BasicQueryEngine<LargeIndexTraits>;
+
+extern template class BasicQueryEngine<CompactIndexTraits>;
+extern template class BasicQueryEngine<LargeIndexTraits>;
+
+#endif // QUERY_ENGINE_H
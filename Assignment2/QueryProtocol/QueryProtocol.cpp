@@ -0,0 +1,106 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "QueryProtocol.h"
+#include "../ByteCoding/ByteCoding.h"
+#include <bit>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+static_assert(std::endian::native == std::endian::little, "frames are read and written in place as little-endian");
+
+namespace {
+
+    // Reads exactly size bytes; false if the peer closed first
+    bool readFully(int fd, char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::read(fd, data, size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) {
+                throw std::runtime_error(std::string("Could not read from the query server: ") + std::strerror(errno));
+            }
+            if (n == 0) return false;
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+} // namespace
+
+void QueryProtocol::encode(const Frame& frame, std::string& out) {
+    if (frame.body.size() > MAX_FRAME_SIZE - (HEADER_SIZE - LENGTH_SIZE)) {
+        throw std::length_error("Query frame body of " + std::to_string(frame.body.size()) + " bytes is too large");
+    }
+    appendWord(out, static_cast<std::uint32_t>(HEADER_SIZE - LENGTH_SIZE + frame.body.size()));
+    appendWord(out, frame.id);
+    out.push_back(static_cast<char>(frame.code));
+    out.append(frame.body);
+}
+
+size_t QueryProtocol::decode(std::string_view buffer, Frame& frame) {
+    if (buffer.size() < LENGTH_SIZE) return 0;
+    std::uint32_t length = readWord<std::uint32_t>(buffer.data());
+    if (length < HEADER_SIZE - LENGTH_SIZE || length > MAX_FRAME_SIZE) {
+        throw std::runtime_error("Invalid query frame length " + std::to_string(length));
+    }
+    if (buffer.size() - LENGTH_SIZE < length) return 0;
+    frame.id = readWord<std::uint32_t>(buffer.data() + LENGTH_SIZE);
+    frame.code = static_cast<std::uint8_t>(buffer[HEADER_SIZE - 1]);
+    frame.body.assign(buffer.data() + HEADER_SIZE, length - (HEADER_SIZE - LENGTH_SIZE));
+    return LENGTH_SIZE + length;
+}
+
+int QueryProtocol::connect(const std::string& socketPath) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path is too long: " + socketPath);
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0 || ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+        std::string reason = std::strerror(errno);
+        if (fd >= 0) ::close(fd);
+        throw std::runtime_error("Could not connect to '" + socketPath + "': " + reason);
+    }
+    return fd;
+}
+
+void QueryProtocol::writeFrame(int fd, const Frame& frame) {
+    std::string bytes;
+    encode(frame, bytes);
+    size_t written = 0;
+    while (written < bytes.size()) {
+        ssize_t n = ::send(fd, bytes.data() + written, bytes.size() - written, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            throw std::runtime_error(std::string("Could not write to the query server: ") + std::strerror(errno));
+        }
+        written += static_cast<size_t>(n);
+    }
+}
+
+bool QueryProtocol::readFrame(int fd, Frame& frame) {
+    char header[HEADER_SIZE];
+    if (!readFully(fd, header, LENGTH_SIZE)) return false;
+    std::uint32_t length = readWord<std::uint32_t>(header);
+    if (length < HEADER_SIZE - LENGTH_SIZE || length > MAX_FRAME_SIZE) {
+        throw std::runtime_error("Invalid query frame length " + std::to_string(length));
+    }
+    if (!readFully(fd, header + LENGTH_SIZE, HEADER_SIZE - LENGTH_SIZE)) {
+        throw std::runtime_error("Query server closed the connection mid-frame");
+    }
+    frame.id = readWord<std::uint32_t>(header + LENGTH_SIZE);
+    frame.code = static_cast<std::uint8_t>(header[HEADER_SIZE - 1]);
+    frame.body.resize(length - (HEADER_SIZE - LENGTH_SIZE));
+    if (!readFully(fd, frame.body.data(), frame.body.size())) {
+        throw std::runtime_error("Query server closed the connection mid-frame");
+    }
+    return true;
+}
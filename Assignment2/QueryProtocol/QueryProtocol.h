@@ -0,0 +1,64 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Length-prefixed binary frames spoken by the query server and its clients
+//
+
+#ifndef QUERY_PROTOCOL_H
+#define QUERY_PROTOCOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+/**
+ * @class QueryProtocol
+ * @brief Frames exchanged over the query server's Unix domain socket.
+ *
+ * Every frame, in either direction (all integers little-endian):
+ *   u32 length   bytes after this field: 5 + body size, at most MAX_FRAME_SIZE
+ *   u32 id       chosen by the client, echoed in the reply
+ *   u8  code     request Type, or reply Status
+ *   body         request: the query line; reply: the result text or error message
+ *
+ * A query line uses the BatchQueryRunner syntax ("token <word>", "length <n>",
+ * "section <A-Z|*>", "query <expr>"). A client may send several requests before
+ * reading; replies can come back in any order and are matched by id.
+ * Linux / POSIX only.
+ */
+class QueryProtocol {
+public:
+    static constexpr size_t LENGTH_SIZE = 4;
+    static constexpr size_t HEADER_SIZE = 9;  // length, id, code
+    static constexpr std::uint32_t MAX_FRAME_SIZE = 1u << 20;
+
+    enum class Type : std::uint8_t {
+        Query = 1,  // Evaluate the body as a query line
+        Stats = 2,  // Server counters as text; the body is ignored
+    };
+
+    enum class Status : std::uint8_t {
+        Ok = 0,
+        Error = 1,  // Malformed query or request; the body says why
+    };
+
+    struct Frame {
+        std::uint32_t id = 0;
+        std::uint8_t code = 0;
+        std::string body;
+    };
+
+    // Append frame to out. Throws std::length_error if the body is too large.
+    static void encode(const Frame& frame, std::string& out);
+    // Decode the frame at the front of buffer: its size, or 0 if it is not complete yet.
+    // Throws std::runtime_error if the length field is out of range.
+    static size_t decode(std::string_view buffer, Frame& frame);
+
+    // Blocking client helpers. Throw std::runtime_error on failure.
+    static int connect(const std::string& socketPath);
+    static void writeFrame(int fd, const Frame& frame);
+    // False if the peer closed the connection before a frame started
+    static bool readFrame(int fd, Frame& frame);
+};
+
+#endif // QUERY_PROTOCOL_H
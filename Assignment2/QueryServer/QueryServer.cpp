@@ -0,0 +1,380 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "QueryServer.h"
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "../BatchQueryRunner/BatchQueryRunner.h"
+
+namespace {
+
+    // epoll keys; connections are numbered from FIRST_CONNECTION and never reused
+    const std::uint64_t LISTENER = 0;
+    const std::uint64_t STOP = 1;
+    const std::uint64_t COMPLETIONS = 2;
+    const std::uint64_t FIRST_CONNECTION = 3;
+
+    const size_t READ_CHUNK = 64 * 1024;
+
+    std::runtime_error systemError(const std::string& what, const std::string& path) {
+        return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+    }
+
+    void drainEventFd(int fd) {
+        std::uint64_t count = 0;
+        while (::read(fd, &count, sizeof(count)) < 0 && errno == EINTR) {
+        }
+    }
+
+    // True if a server is accepting connections on the socket at path
+    bool socketInUse(const sockaddr_un& address) {
+        int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (probe < 0) return false;
+        bool connected = ::connect(probe, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        ::close(probe);
+        return connected;
+    }
+
+} // namespace
+
+// Constructor - binds the socket; serving starts with run()
+template <typename Traits>
+BasicQueryServer<Traits>::BasicQueryServer(const std::string& socketPath, versions_type& versions,
+                                           size_t threadCount)
+    : socketPath(socketPath), versions(versions), nextConnection(FIRST_CONNECTION), pool(threadCount) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (socketPath.empty() || socketPath.size() >= sizeof(address.sun_path)) {
+        throw std::runtime_error("Socket path is empty or too long: '" + socketPath + "'");
+    }
+    std::memcpy(address.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+    try {
+        // A socket file left by a server that is gone is replaced; a live one is not
+        struct stat status {};
+        if (::lstat(socketPath.c_str(), &status) == 0) {
+            if (!S_ISSOCK(status.st_mode)) {
+                throw std::runtime_error("'" + socketPath + "' exists and is not a socket");
+            }
+            if (socketInUse(address)) {
+                throw std::runtime_error("A server is already listening on '" + socketPath + "'");
+            }
+            ::unlink(socketPath.c_str());
+        }
+
+        listenFd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listenFd < 0) throw systemError("Could not create socket", socketPath);
+        if (::bind(listenFd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+            throw systemError("Could not bind socket", socketPath);
+        }
+        if (::listen(listenFd, SOMAXCONN) != 0) throw systemError("Could not listen on", socketPath);
+
+        epollFd = ::epoll_create1(EPOLL_CLOEXEC);
+        stopFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        completionFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epollFd < 0 || stopFd < 0 || completionFd < 0) {
+            throw systemError("Could not create the event loop for", socketPath);
+        }
+        watch(listenFd, LISTENER, EPOLLIN);
+        watch(stopFd, STOP, EPOLLIN);
+        watch(completionFd, COMPLETIONS, EPOLLIN);
+    } catch (...) {
+        closeDescriptors();
+        throw;
+    }
+}
+
+// Destructor
+template <typename Traits>
+BasicQueryServer<Traits>::~BasicQueryServer() {
+    // Workers post to completionFd, so it outlives them
+    pool.waitIdle();
+    for (auto it = connections.begin(); it != connections.end(); ++it) {
+        ::close(it->second.fd);
+    }
+    connections.clear();
+    closeDescriptors();
+    ::unlink(socketPath.c_str());
+}
+
+template <typename Traits>
+void BasicQueryServer<Traits>::closeDescriptors() {
+    const int descriptors[] = {listenFd, epollFd, stopFd, completionFd};
+    for (int fd : descriptors) {
+        if (fd >= 0) ::close(fd);
+    }
+    listenFd = epollFd = stopFd = completionFd = -1;
+}
+
+template <typename Traits>
+void BasicQueryServer<Traits>::watch(int fd, std::uint64_t key, std::uint32_t events) {
+    epoll_event event{};
+    event.events = events;
+    event.data.u64 = key;
+    if (::epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+        throw systemError("Could not watch a descriptor of", socketPath);
+    }
+}
+
+template <typename Traits>
+void BasicQueryServer<Traits>::run() {
+    std::array<epoll_event, 64> events;
+    bool stopping = false;
+    while (!stopping) {
+        int ready = ::epoll_wait(epollFd, events.data(), static_cast<int>(events.size()), -1);
+        if (ready < 0) {
+            if (errno == EINTR) continue;
+            throw systemError("Event loop failed for", socketPath);
+        }
+        for (int i = 0; i < ready; ++i) {
+            std::uint64_t key = events[i].data.u64;
+            std::uint32_t flags = events[i].events;
+            if (key == STOP) {
+                drainEventFd(stopFd);
+                stopping = true;
+            } else if (key == LISTENER) {
+                acceptConnections();
+            } else if (key == COMPLETIONS) {
+                drainEventFd(completionFd);
+                deliverCompletions();
+            } else if (connections.count(key) != 0) {
+                if (flags & (EPOLLERR | EPOLLHUP)) {
+                    closeConnection(key);
+                    continue;
+                }
+                if (flags & EPOLLIN) readFrom(key);
+                if ((flags & EPOLLOUT) && connections.count(key) != 0) writeTo(key);
+            }
+        }
+    }
+    // Replies still being computed are dropped with their connections
+    while (!connections.empty()) {
+        closeConnection(connections.begin()->first);
+    }
+}
+
+template <typename Traits>
+void BasicQueryServer<Traits>::stop() {
+    std::uint64_t one = 1;
+    ssize_t written = ::write(stopFd, &one, sizeof(one));
+    (void)written;  // The counter only fails to grow if it is already nonzero
+}
+
+template <typename Traits>
+void BasicQueryServer<Traits>::acceptConnections() {
+    while (true) {
+        int fd = ::accept4(listenFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return;  // EAGAIN: none left; otherwise (e.g. EMFILE) retried on the next event
+        }
+        std::uint64_t id = nextConnection++;
+        Connection& connection = connections[id];
+        connection.fd = fd;
+        connection.events = EPOLLIN;
+        watch(fd, id, connection.events);
+        connectionCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+template <typename Traits>
+void BasicQueryServer<Traits>::readFrom(std::uint64_t id) {
+    Connection& connection = connections.at(id);
+    char buffer[READ_CHUNK];
+    ssize_t n = ::recv(connection.fd, buffer, sizeof(buffer), 0);
+    if (n < 0) {
+        if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) closeConnection(id);
+        return;
+    }
+    if (n == 0) {
+        // The client is done sending; answer what it asked, then close
+        connection.peerClosed = true;
+        if (connection.inFlight == 0 && connection.output.empty()) {
+            closeConnection(id);
+        } else {
+            updateEvents(id);
+        }
+        return;
+    }
+    bytesIn.fetch_add(static_cast<std::uint64_t>(n), std::memory_order_relaxed);
+    connection.input.append(buffer, static_cast<size_t>(n));
+    dispatchFrames(id);
+}
+
+template <typename Traits>
+bool BasicQueryServer<Traits>::acceptsRequests(const Connection& connection) const {
+    return connection.inFlight < MAX_IN_FLIGHT && connection.output.size() <= OUTPUT_HIGH_WATER;
+}
+
+template <typename Traits>
+void BasicQueryServer<Traits>::dispatchFrames(std::uint64_t id) {
+    Connection& connection = connections.at(id);
+    size_t offset = 0;
+    while (acceptsRequests(connection)) {
+        QueryProtocol::Frame request;
+        size_t used = 0;
+        try {
+            used = QueryProtocol::decode(std::string_view(connection.input).substr(offset), request);
+        } catch (const std::runtime_error&) {
+            // A bad length leaves no way to find the next frame
+            errorCount.fetch_add(1, std::memory_order_relaxed);
+            closeConnection(id);
+            return;
+        }
+        if (used == 0) break;
+        offset += used;
+        ++connection.inFlight;
+
+        pool.enqueue([this, id, request = std::move(request)] {
+            Completion done{id, std::string(), false};
+            QueryProtocol::Frame reply;
+            reply.id = request.id;
+            reply.code = static_cast<std::uint8_t>(QueryProtocol::Status::Ok);
+            try {
+                reply.body = answer(request);
+                QueryProtocol::encode(reply, done.bytes);
+            } catch (const std::exception& e) {
+                done.error = true;
+                done.bytes.clear();
+                reply.code = static_cast<std::uint8_t>(QueryProtocol::Status::Error);
+                reply.body = e.what();
+                QueryProtocol::encode(reply, done.bytes);
+            }
+            {
+                std::lock_guard<std::mutex> lock(completionMutex);
+                completions.push_back(std::move(done));
+            }
+            std::uint64_t one = 1;
+            ssize_t written = ::write(completionFd, &one, sizeof(one));
+            (void)written;
+        });
+    }
+    connection.input.erase(0, offset);
+    updateEvents(id);
+}
+
+// Runs on a worker
+template <typename Traits>
+std::string BasicQueryServer<Traits>::answer(const QueryProtocol::Frame& request) const {
+    switch (static_cast<QueryProtocol::Type>(request.code)) {
+        case QueryProtocol::Type::Query: {
+            typename versions_type::snapshot_type snapshot = versions.acquire();
+            return BasicBatchQueryRunner<Traits>::evaluate(*snapshot, request.body);
+        }
+        case QueryProtocol::Type::Stats: {
+            Stats stats = getStats();
+            std::ostringstream out;
+            out << "connections " << stats.connections << '\n'
+                << "requests " << stats.requests << '\n'
+                << "errors " << stats.errors << '\n'
+                << "bytes in " << stats.bytesIn << '\n'
+                << "bytes out " << stats.bytesOut << '\n'
+                << "index version " << versions.getStats().generation << '\n';
+            return std::move(out).str();
+        }
+    }
+    throw std::invalid_argument("Unknown request type " + std::to_string(request.code));
+}
+
+template <typename Traits>
+void BasicQueryServer<Traits>::deliverCompletions() {
+    std::vector<Completion> ready;
+    {
+        std::lock_guard<std::mutex> lock(completionMutex);
+        ready.swap(completions);
+    }
+    std::vector<std::uint64_t> touched;
+    for (auto it = ready.begin(); it != ready.end(); ++it) {
+        requestCount.fetch_add(1, std::memory_order_relaxed);
+        if (it->error) errorCount.fetch_add(1, std::memory_order_relaxed);
+        auto found = connections.find(it->connection);
+        if (found == connections.end()) continue;  // Closed while the query ran
+        --found->second.inFlight;
+        found->second.output += it->bytes;
+        if (touched.empty() || touched.back() != it->connection) touched.push_back(it->connection);
+    }
+    for (auto it = touched.begin(); it != touched.end(); ++it) {
+        if (connections.count(*it) != 0) writeTo(*it);
+    }
+}
+
+template <typename Traits>
+void BasicQueryServer<Traits>::writeTo(std::uint64_t id) {
+    Connection& connection = connections.at(id);
+    size_t written = 0;
+    while (written < connection.output.size()) {
+        ssize_t n = ::send(connection.fd, connection.output.data() + written, connection.output.size() - written,
+                           MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            closeConnection(id);
+            return;
+        }
+        written += static_cast<size_t>(n);
+    }
+    bytesOut.fetch_add(written, std::memory_order_relaxed);
+    connection.output.erase(0, written);
+    if (connection.peerClosed && connection.inFlight == 0 && connection.output.empty()) {
+        closeConnection(id);
+        return;
+    }
+    // Frames held back by the in-flight limit or the high-water mark
+    if (!connection.input.empty() && acceptsRequests(connection)) {
+        dispatchFrames(id);
+        return;
+    }
+    updateEvents(id);
+}
+
+template <typename Traits>
+void BasicQueryServer<Traits>::updateEvents(std::uint64_t id) {
+    Connection& connection = connections.at(id);
+    std::uint32_t wanted = 0;
+    if (!connection.peerClosed && acceptsRequests(connection)) wanted |= EPOLLIN;
+    if (!connection.output.empty()) wanted |= EPOLLOUT;
+    if (wanted == connection.events) return;
+    epoll_event event{};
+    event.events = wanted;
+    event.data.u64 = id;
+    if (::epoll_ctl(epollFd, EPOLL_CTL_MOD, connection.fd, &event) != 0) {
+        closeConnection(id);
+        return;
+    }
+    connection.events = wanted;
+}
+
+template <typename Traits>
+void BasicQueryServer<Traits>::closeConnection(std::uint64_t id) {
+    auto found = connections.find(id);
+    if (found == connections.end()) return;
+    ::epoll_ctl(epollFd, EPOLL_CTL_DEL, found->second.fd, nullptr);
+    ::close(found->second.fd);
+    connections.erase(found);
+}
+
+template <typename Traits>
+typename BasicQueryServer<Traits>::Stats BasicQueryServer<Traits>::getStats() const {
+    Stats stats;
+    stats.connections = connectionCount.load(std::memory_order_relaxed);
+    stats.requests = requestCount.load(std::memory_order_relaxed);
+    stats.errors = errorCount.load(std::memory_order_relaxed);
+    stats.bytesIn = bytesIn.load(std::memory_order_relaxed);
+    stats.bytesOut = bytesOut.load(std::memory_order_relaxed);
+    return stats;
+}
+
+template class BasicQueryServer<CompactIndexTraits>;
+template class BasicQueryServer<LargeIndexTraits>;
@@ -0,0 +1,134 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Query daemon: an index served over a Unix domain socket
+//
+
+#ifndef QUERY_SERVER_H
+#define QUERY_SERVER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "../QueryProtocol/QueryProtocol.h"
+#include "../ThreadPool/ThreadPool.h"
+#include "../VersionedIndex/VersionedIndex.h"
+
+/**
+ * @class BasicQueryServer
+ * @brief Answers QueryProtocol requests on a Unix domain socket from a VersionedIndex.
+ *
+ * One thread runs an epoll loop that accepts connections, reads and splits frames
+ * and writes replies; it never evaluates a query. Each request is handed to a
+ * ThreadPool worker, which answers it from the index version current at that
+ * moment (so the index can be rebuilt or reloaded while the server runs) and
+ * passes the encoded reply back to the loop through an eventfd. A connection with
+ * MAX_IN_FLIGHT requests unanswered, or more than OUTPUT_HIGH_WATER reply bytes it
+ * has not read yet, is not read from until that drains, so one client cannot queue
+ * unbounded work or unbounded replies. Linux only.
+ */
+template <typename Traits>
+class BasicQueryServer {
+public:
+    using versions_type = BasicVersionedIndex<Traits>;
+
+    static const size_t MAX_IN_FLIGHT = 64;  // Unanswered requests per connection
+    static const size_t OUTPUT_HIGH_WATER = 4 << 20;  // Unwritten reply bytes per connection
+
+    struct Stats {
+        std::uint64_t connections = 0;     // Accepted so far
+        std::uint64_t requests = 0;        // Requests answered
+        std::uint64_t errors = 0;          // Error replies, plus connections dropped for bad frames
+        std::uint64_t bytesIn = 0;
+        std::uint64_t bytesOut = 0;
+    };
+
+private:
+    struct Connection {
+        int fd = -1;
+        std::string input;   // Bytes not yet split into frames
+        std::string output;  // Reply bytes not yet written
+        size_t inFlight = 0;
+        bool peerClosed = false;   // Read end finished; closed once the replies are out
+        std::uint32_t events = 0;  // Registered with epoll
+    };
+
+    // An encoded reply on its way from a worker to the loop
+    struct Completion {
+        std::uint64_t connection;
+        std::string bytes;
+        bool error;
+    };
+
+    std::string socketPath;
+    versions_type& versions;
+    int listenFd = -1;
+    int epollFd = -1;
+    int stopFd = -1;        // eventfd: stop() was called
+    int completionFd = -1;  // eventfd: completions are waiting
+    std::unordered_map<std::uint64_t, Connection> connections;  // Loop thread only
+    std::uint64_t nextConnection;
+
+    std::mutex completionMutex;
+    std::vector<Completion> completions;
+
+    std::atomic<std::uint64_t> connectionCount{0};
+    std::atomic<std::uint64_t> requestCount{0};
+    std::atomic<std::uint64_t> errorCount{0};
+    std::atomic<std::uint64_t> bytesIn{0};
+    std::atomic<std::uint64_t> bytesOut{0};
+
+    ThreadPool pool;
+
+    void closeDescriptors();
+    void watch(int fd, std::uint64_t key, std::uint32_t events);
+    void acceptConnections();
+    void readFrom(std::uint64_t id);
+    // Under the in-flight limit and the output high-water mark
+    bool acceptsRequests(const Connection& connection) const;
+    // Hand complete frames to the pool while the connection accepts requests
+    void dispatchFrames(std::uint64_t id);
+    std::string answer(const QueryProtocol::Frame& request) const;
+    void deliverCompletions();
+    void writeTo(std::uint64_t id);
+    // EPOLLIN while the connection accepts requests, EPOLLOUT while output is pending
+    void updateEvents(std::uint64_t id);
+    void closeConnection(std::uint64_t id);
+
+public:
+    /**
+     * @brief Listen on socketPath (replacing a stale socket left there) with
+     * threadCount query workers (0 = one per hardware thread).
+     * Throws std::runtime_error if the socket cannot be set up.
+     */
+    BasicQueryServer(const std::string& socketPath, versions_type& versions, size_t threadCount = 0);
+
+    BasicQueryServer(const BasicQueryServer& other) = delete;
+    BasicQueryServer& operator=(const BasicQueryServer& other) = delete;
+
+    // Waits for running queries, closes the socket and removes its path
+    ~BasicQueryServer();
+
+    /**
+     * @brief Serve until stop() is called; connections are closed on return
+     */
+    void run();
+
+    /**
+     * @brief Make run() return; safe from any thread and from a signal handler
+     */
+    void stop();
+
+    Stats getStats() const;
+};
+
+using QueryServer = BasicQueryServer<CompactIndexTraits>;
+using LargeQueryServer = BasicQueryServer<LargeIndexTraits>;
+
+extern template class BasicQueryServer<CompactIndexTraits>;
+extern template class BasicQueryServer<LargeIndexTraits>;
+
+#endif // QUERY_SERVER_H
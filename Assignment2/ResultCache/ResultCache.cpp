@@ -0,0 +1,73 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "ResultCache.h"
+#include <functional>
+
+size_t ResultCache::KeyHash::operator()(const Key& key) const {
+    size_t seed = std::hash<std::string>{}(key.argument);
+    // boost::hash_combine mixing
+    seed ^= std::hash<int>{}(key.kind) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    seed ^= std::hash<std::uint64_t>{}(key.version) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    return seed;
+}
+
+// Constructor
+ResultCache::ResultCache(size_t maxEntries, size_t maxBytes) : maxEntries(maxEntries), maxBytes(maxBytes) {}
+
+ResultCache::value_type ResultCache::find(const Key& key) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = positions.find(key);
+    if (it == positions.end()) {
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    hits.fetch_add(1, std::memory_order_relaxed);
+    entries.splice(entries.begin(), entries, it->second);
+    return it->second->second;
+}
+
+ResultCache::value_type ResultCache::insert(Key key, std::string result) {
+    auto value = std::make_shared<const std::string>(std::move(result));
+    if (value->size() > maxBytes || maxEntries == 0) return value;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = positions.find(key);
+    if (it != positions.end()) {
+        // Another thread rendered the same result first; keep the newer copy
+        bytes -= it->second->second->size();
+        entries.erase(it->second);
+        positions.erase(it);
+    }
+    entries.emplace_front(std::move(key), value);
+    positions.emplace(entries.front().first, entries.begin());
+    bytes += value->size();
+    evictToFit();
+    return value;
+}
+
+void ResultCache::evictToFit() {
+    while (!entries.empty() && (entries.size() > maxEntries || bytes > maxBytes)) {
+        bytes -= entries.back().second->size();
+        positions.erase(entries.back().first);
+        entries.pop_back();
+    }
+}
+
+void ResultCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    positions.clear();
+    entries.clear();
+    bytes = 0;
+}
+
+ResultCache::Stats ResultCache::stats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats result;
+    result.hits = hits.load(std::memory_order_relaxed);
+    result.misses = misses.load(std::memory_order_relaxed);
+    result.entries = entries.size();
+    result.bytes = bytes;
+    return result;
+}
@@ -0,0 +1,92 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#ifndef RESULT_CACHE_H
+#define RESULT_CACHE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @class ResultCache
+ * @brief Bounded LRU cache of rendered query results.
+ *
+ * Entries are keyed on (query kind, argument, index version). A caller that
+ * bumps its version on every change never reads a stale result; old entries
+ * simply age out. Bounded by entry count and by total bytes. All members are
+ * safe to call from several threads.
+ */
+class ResultCache {
+public:
+    struct Key {
+        int kind = 0;           // Caller-defined query type
+        std::string argument;   // Query argument in text form
+        std::uint64_t version = 0;  // Index version the result was rendered from
+
+        bool operator==(const Key& other) const = default;
+    };
+
+    struct Stats {
+        std::uint64_t hits = 0;
+        std::uint64_t misses = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+    };
+
+    // Results are shared so a hit can be written out after the lock is released
+    using value_type = std::shared_ptr<const std::string>;
+
+    static const size_t DEFAULT_MAX_ENTRIES = 256;
+    static const size_t DEFAULT_MAX_BYTES = 32 * 1024 * 1024;
+
+private:
+    struct KeyHash {
+        size_t operator()(const Key& key) const;
+    };
+    using entry_list = std::list<std::pair<Key, value_type>>;  // Most recently used first
+
+    entry_list entries;
+    std::unordered_map<Key, entry_list::iterator, KeyHash> positions;
+    size_t maxEntries;
+    size_t maxBytes;
+    size_t bytes = 0;
+    std::atomic<std::uint64_t> hits{0};
+    std::atomic<std::uint64_t> misses{0};
+    mutable std::mutex mutex;
+
+    void evictToFit();  // caller holds mutex
+
+public:
+    explicit ResultCache(size_t maxEntries = DEFAULT_MAX_ENTRIES, size_t maxBytes = DEFAULT_MAX_BYTES);
+
+    // The mutex and counters are not copyable
+    ResultCache(const ResultCache& other) = delete;
+    ResultCache& operator=(const ResultCache& other) = delete;
+
+    /**
+     * @brief The cached result for key (marked most recently used), or nullptr; counts a hit or miss
+     */
+    value_type find(const Key& key);
+
+    /**
+     * @brief Store a result, evicting least recently used entries to stay in bounds.
+     * Results larger than the byte budget are returned without being kept.
+     */
+    value_type insert(Key key, std::string result);
+
+    /**
+     * @brief Drop every entry (counters are kept)
+     */
+    void clear();
+
+    Stats stats() const;
+};
+
+#endif // RESULT_CACHE_H
@@ -0,0 +1,223 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "SegmentedIndex.h"
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+// Constructor - starts the merger thread
+template <typename Traits>
+BasicSegmentedIndex<Traits>::BasicSegmentedIndex(bool positional, bool caseInsensitive)
+    : positional(positional), caseInsensitive(caseInsensitive) {
+    merger = std::thread(&BasicSegmentedIndex::mergeLoop, this);
+}
+
+// Destructor
+template <typename Traits>
+BasicSegmentedIndex<Traits>::~BasicSegmentedIndex() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    changed.notify_all();
+    merger.join();
+}
+
+template <typename Traits>
+bool BasicSegmentedIndex<Traits>::findMergeRun(size_t& first) const {
+    for (size_t i = 0; i + MERGE_FAN_IN <= segments.size(); ++i) {
+        auto runEnd = segments.begin() + static_cast<std::ptrdiff_t>(i + MERGE_FAN_IN);
+        size_t level = segments[i].level;
+        if (std::all_of(segments.begin() + static_cast<std::ptrdiff_t>(i), runEnd,
+                        [level](const Segment& segment) { return segment.level == level; })) {
+            first = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Merger thread: the run is merged without the lock held; ingest only appends
+// segments, so the run is still in place when the merged segment replaces it.
+// An error must not escape the thread: the run is left as it is and merging stops,
+// since the same run would only fail again
+template <typename Traits>
+void BasicSegmentedIndex<Traits>::mergeLoop() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        size_t first = 0;
+        changed.wait(lock, [&] { return stopping || (!mergeFailure && findMergeRun(first)); });
+        if (stopping) return;
+        std::vector<Segment> run(segments.begin() + static_cast<std::ptrdiff_t>(first),
+                                 segments.begin() + static_cast<std::ptrdiff_t>(first + MERGE_FAN_IN));
+        merging = true;
+        lock.unlock();
+
+        std::shared_ptr<const indexer_type> combined;
+        std::uint64_t lines = 0;
+        try {
+            std::vector<const indexer_type*> parts;
+            std::vector<line_type> offsets;
+            for (auto it = run.cbegin(); it != run.cend(); ++it) {
+                parts.push_back(it->index.get());
+                offsets.push_back(it->lineOffset - run.front().lineOffset);
+                lines += it->index->getLineCount();
+            }
+            combined = std::make_shared<const indexer_type>(indexer_type::merged(parts, offsets));
+        } catch (...) {
+            lock.lock();
+            mergeFailure = std::current_exception();
+            merging = false;
+            changed.notify_all();
+            continue;
+        }
+
+        lock.lock();
+        segments[first] = Segment{std::move(combined), run.front().lineOffset, run.front().level + 1};
+        segments.erase(segments.begin() + static_cast<std::ptrdiff_t>(first + 1),
+                       segments.begin() + static_cast<std::ptrdiff_t>(first + MERGE_FAN_IN));
+        merging = false;
+        ++stats.merges;
+        stats.linesMerged += lines;
+        changed.notify_all();
+    }
+}
+
+// The new segment is built before the lock is taken; queries and the merger
+// only wait for it to be appended
+template <typename Traits>
+void BasicSegmentedIndex<Traits>::ingest(const std::vector<std::string>& lines) {
+    if (lines.empty()) return;
+    auto segment = std::make_shared<indexer_type>();
+    segment->setPositional(positional);
+    segment->setCaseInsensitive(caseInsensitive);
+    for (auto it = lines.cbegin(); it != lines.cend(); ++it) {
+        segment->processLine(*it);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (lines.size() > std::numeric_limits<line_type>::max() - lineCount) {
+            throw std::overflow_error("line count exceeds the index width; use LargeSegmentedIndex");
+        }
+        // Merges add up the segments' token counts, so the total must fit as well
+        count_type tokens = segment->getTokenCount();
+        if (tokens > std::numeric_limits<count_type>::max() - tokenCount) {
+            throw std::overflow_error("token count exceeds the index width; use LargeSegmentedIndex");
+        }
+        segments.push_back(Segment{std::move(segment), static_cast<line_type>(lineCount), 0});
+        lineCount += static_cast<count_type>(lines.size());
+        tokenCount += tokens;
+        ++stats.ingests;
+        stats.linesIngested += lines.size();
+    }
+    changed.notify_all();
+}
+
+template <typename Traits>
+void BasicSegmentedIndex<Traits>::ingestFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        throw std::runtime_error("Could not open file '" + filename + "'");
+    }
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(file, line)) {
+        lines.push_back(std::move(line));
+    }
+    ingest(lines);
+}
+
+template <typename Traits>
+void BasicSegmentedIndex<Traits>::waitForMerges() {
+    std::unique_lock<std::mutex> lock(mutex);
+    size_t first = 0;
+    changed.wait(lock, [&] { return !merging && (mergeFailure || !findMergeRun(first)); });
+    if (mergeFailure) {
+        std::rethrow_exception(mergeFailure);
+    }
+}
+
+template <typename Traits>
+std::vector<typename BasicSegmentedIndex<Traits>::Segment> BasicSegmentedIndex<Traits>::liveSegments() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return segments;
+}
+
+// Segments cover consecutive line ranges, so their postings concatenate in order
+template <typename Traits>
+std::vector<typename BasicSegmentedIndex<Traits>::line_type>
+BasicSegmentedIndex<Traits>::occurrences(const std::string& token) const {
+    std::vector<line_type> lines;
+    std::vector<Segment> live = liveSegments();
+    for (auto segment = live.cbegin(); segment != live.cend(); ++segment) {
+        if (const auto* entry = segment->index->findToken(token)) {
+            const std::vector<line_type>& local = entry->getLineNumbers();
+            for (auto it = local.cbegin(); it != local.cend(); ++it) {
+                lines.push_back(*it + segment->lineOffset);
+            }
+        }
+    }
+    return lines;
+}
+
+template <typename Traits>
+std::vector<std::string> BasicSegmentedIndex<Traits>::findPrefix(const std::string& prefix) const {
+    // (section, key) is index order across sections
+    std::vector<std::pair<int, std::string>> keys;
+    std::vector<Segment> live = liveSegments();
+    for (auto segment = live.cbegin(); segment != live.cend(); ++segment) {
+        std::vector<const typename indexer_type::token_type*> matches = segment->index->findPrefix(prefix);
+        for (auto it = matches.cbegin(); it != matches.cend(); ++it) {
+            keys.emplace_back(getSectionIndex((*it)->getKey()[0]), (*it)->getKey());
+        }
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+    std::vector<std::string> result;
+    result.reserve(keys.size());
+    for (auto it = keys.begin(); it != keys.end(); ++it) {
+        result.push_back(std::move(it->second));
+    }
+    return result;
+}
+
+template <typename Traits>
+typename BasicSegmentedIndex<Traits>::indexer_type BasicSegmentedIndex<Traits>::snapshot() const {
+    std::vector<Segment> live = liveSegments();
+    std::vector<const indexer_type*> parts;
+    std::vector<line_type> offsets;
+    for (auto it = live.cbegin(); it != live.cend(); ++it) {
+        parts.push_back(it->index.get());
+        offsets.push_back(it->lineOffset);
+    }
+    if (parts.empty()) {
+        indexer_type empty;
+        empty.setPositional(positional);
+        empty.setCaseInsensitive(caseInsensitive);
+        return empty;
+    }
+    return indexer_type::merged(parts, offsets);
+}
+
+template <typename Traits>
+typename BasicSegmentedIndex<Traits>::count_type BasicSegmentedIndex<Traits>::getLineCount() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return lineCount;
+}
+
+template <typename Traits>
+typename BasicSegmentedIndex<Traits>::Stats BasicSegmentedIndex<Traits>::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    Stats current = stats;
+    current.segments = segments.size();
+    return current;
+}
+
+template class BasicSegmentedIndex<CompactIndexTraits>;
+template class BasicSegmentedIndex<LargeIndexTraits>;
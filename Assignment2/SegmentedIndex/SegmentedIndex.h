@@ -0,0 +1,111 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Index kept as immutable sorted segments, merged in the background (log-structured)
+//
+
+#ifndef SEGMENTED_INDEX_H
+#define SEGMENTED_INDEX_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../Indexer/Indexer.h"
+
+/**
+ * @class BasicSegmentedIndex
+ * @brief A growing index built from batches of lines without rewriting what is
+ * already indexed.
+ *
+ * Each ingest() indexes its batch into a new segment, an immutable index over the
+ * batch's own line numbers plus the offset of its first line. A background thread
+ * merges MERGE_FAN_IN adjacent segments of the same level into one segment of the
+ * next level (Indexer::merged), so every line is rewritten once per level:
+ * write amplification grows with log(corpus / batch) and ingest latency with the
+ * batch alone. Queries fan out over the segments live when they start and merge
+ * their answers; they never wait for a merge. A merge that throws leaves its run
+ * unmerged and stops further merging; waitForMerges() rethrows its error.
+ */
+template <typename Traits>
+class BasicSegmentedIndex {
+public:
+    using indexer_type = BasicIndexer<Traits>;
+    using line_type = typename indexer_type::line_type;
+    using count_type = typename indexer_type::count_type;
+
+    static const size_t MERGE_FAN_IN = 4;  // Segments of one level merged together
+
+    struct Segment {
+        std::shared_ptr<const indexer_type> index;
+        line_type lineOffset = 0;  // Added to the segment's line numbers
+        size_t level = 0;          // Number of merges behind the segment
+    };
+
+    struct Stats {
+        size_t segments = 0;
+        std::uint64_t ingests = 0;
+        std::uint64_t merges = 0;
+        std::uint64_t linesIngested = 0;
+        std::uint64_t linesMerged = 0;  // Lines rewritten by merges (write amplification)
+    };
+
+private:
+    bool positional;
+    bool caseInsensitive;
+    mutable std::mutex mutex;
+    std::condition_variable changed;  // Segments added, merge finished, or stopping
+    std::vector<Segment> segments;    // In line order
+    count_type lineCount = 0;
+    count_type tokenCount = 0;
+    bool merging = false;
+    std::exception_ptr mergeFailure;  // Set by the merge that failed, if any
+    bool stopping = false;
+    Stats stats;
+    std::thread merger;
+
+    // First of MERGE_FAN_IN adjacent segments of one level, if any; caller holds mutex
+    bool findMergeRun(size_t& first) const;
+    void mergeLoop();
+    // Segments live right now
+    std::vector<Segment> liveSegments() const;
+
+public:
+    explicit BasicSegmentedIndex(bool positional = false, bool caseInsensitive = false);
+
+    BasicSegmentedIndex(const BasicSegmentedIndex& other) = delete;
+    BasicSegmentedIndex& operator=(const BasicSegmentedIndex& other) = delete;
+
+    // Stops the merger once a running merge has finished
+    ~BasicSegmentedIndex();
+
+    // Index lines as the next lines of the corpus, as one new segment
+    void ingest(const std::vector<std::string>& lines);
+    void ingestFile(const std::string& filename);
+
+    // Block until no merge is due; rethrows the error of a failed merge
+    void waitForMerges();
+
+    // Fan-out queries
+    // Lines containing token, in order
+    std::vector<line_type> occurrences(const std::string& token) const;
+    // Distinct keys starting with prefix, in index order
+    std::vector<std::string> findPrefix(const std::string& prefix) const;
+    // One index equal to the live segments merged (e.g. to print or save)
+    indexer_type snapshot() const;
+
+    count_type getLineCount() const;
+    Stats getStats() const;
+};
+
+using SegmentedIndex = BasicSegmentedIndex<CompactIndexTraits>;
+using LargeSegmentedIndex = BasicSegmentedIndex<LargeIndexTraits>;
+
+extern template class BasicSegmentedIndex<CompactIndexTraits>;
+extern template class BasicSegmentedIndex<LargeIndexTraits>;
+
+#endif // SEGMENTED_INDEX_H
@@ -0,0 +1,64 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief Fixed set of worker threads draining a shared FIFO of tasks.
+ *
+ * Tasks must not throw; wrap work that can fail and record the error instead.
+ */
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable taskReady;  // Signalled when a task is queued or on shutdown
+    std::condition_variable idle;       // Signalled when the last running task finishes
+    size_t running = 0;                 // Tasks currently executing
+    bool stopping = false;
+
+    void workerLoop();
+
+public:
+    /**
+     * @brief Start threadCount workers (0 = one per hardware thread)
+     */
+    explicit ThreadPool(size_t threadCount = 0);
+
+    // Workers hold a pointer to the pool: not copyable or movable
+    ThreadPool(const ThreadPool& other) = delete;
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+    ThreadPool(ThreadPool&& other) = delete;
+    ThreadPool& operator=(ThreadPool&& other) = delete;
+
+    /**
+     * @brief Finishes the queued tasks, then joins the workers
+     */
+    ~ThreadPool();
+
+    /**
+     * @brief Queue a task for any worker
+     */
+    void enqueue(std::function<void()> task);
+
+    /**
+     * @brief Block until the queue is empty and no task is running
+     */
+    void waitIdle();
+
+    size_t size() const;
+};
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,99 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "VersionedIndex.h"
+#include <thread>
+#include <utility>
+
+// Constructor
+template <typename Traits>
+BasicVersionedIndex<Traits>::BasicVersionedIndex(indexer_type initial)
+    : live(std::make_shared<std::atomic<std::uint64_t>>(0)) {
+    current.store(new snapshot_type(adopt(std::move(initial))));
+}
+
+// Destructor; versions still held by readers outlive it
+template <typename Traits>
+BasicVersionedIndex<Traits>::~BasicVersionedIndex() {
+    delete current.load();
+}
+
+template <typename Traits>
+typename BasicVersionedIndex<Traits>::snapshot_type BasicVersionedIndex<Traits>::adopt(indexer_type&& index) const {
+    auto* version = new indexer_type(std::move(index));
+    live->fetch_add(1, std::memory_order_relaxed);
+    // The last reader to release a version frees it
+    return snapshot_type(version, [counter = live](const indexer_type* retired) {
+        delete retired;
+        counter->fetch_sub(1, std::memory_order_relaxed);
+    });
+}
+
+template <typename Traits>
+std::uint64_t BasicVersionedIndex<Traits>::install(indexer_type&& next) {
+    const snapshot_type* retired = current.exchange(new snapshot_type(adopt(std::move(next))));
+
+    // Grace period: readers that entered under the old epoch may still be copying
+    // retired; later ones see the new epoch and so the new version
+    std::uint64_t ended = epoch.fetch_add(1);
+    while (readers[ended & 1].load() != 0) {
+        std::this_thread::yield();
+    }
+    // The previous version is dropped here unless a reader still holds it
+    delete retired;
+    return generation.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+template <typename Traits>
+typename BasicVersionedIndex<Traits>::snapshot_type BasicVersionedIndex<Traits>::acquire() const {
+    for (;;) {
+        std::uint64_t entered = epoch.load();
+        std::atomic<std::uint64_t>& active = readers[entered & 1];
+        active.fetch_add(1);
+        // Still the same epoch: the writer that ends it will wait for this reader
+        if (epoch.load() == entered) {
+            snapshot_type snapshot = *current.load();
+            active.fetch_sub(1);
+            return snapshot;
+        }
+        active.fetch_sub(1);
+    }
+}
+
+template <typename Traits>
+std::uint64_t BasicVersionedIndex<Traits>::publish(indexer_type next) {
+    std::lock_guard<std::mutex> lock(writer);
+    return install(std::move(next));
+}
+
+template <typename Traits>
+std::uint64_t BasicVersionedIndex<Traits>::rebuild(const builder_type& build) {
+    std::lock_guard<std::mutex> lock(writer);
+    snapshot_type base = acquire();
+    indexer_type next;
+    next.setPositional(base->isPositional());
+    next.setCaseInsensitive(base->isCaseInsensitive());
+    base.reset();
+    build(next);
+    return install(std::move(next));
+}
+
+template <typename Traits>
+std::uint64_t BasicVersionedIndex<Traits>::update(const builder_type& edit) {
+    std::lock_guard<std::mutex> lock(writer);
+    indexer_type next(*acquire());
+    edit(next);
+    return install(std::move(next));
+}
+
+template <typename Traits>
+typename BasicVersionedIndex<Traits>::Stats BasicVersionedIndex<Traits>::getStats() const {
+    Stats stats;
+    stats.generation = generation.load(std::memory_order_relaxed);
+    stats.live = live->load(std::memory_order_relaxed);
+    return stats;
+}
+
+template class BasicVersionedIndex<CompactIndexTraits>;
+template class BasicVersionedIndex<LargeIndexTraits>;
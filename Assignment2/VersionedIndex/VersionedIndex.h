@@ -0,0 +1,88 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Published immutable index versions: readers take a snapshot, writers build the next version aside
+//
+
+#ifndef VERSIONED_INDEX_H
+#define VERSIONED_INDEX_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include "../Indexer/Indexer.h"
+
+/**
+ * @class BasicVersionedIndex
+ * @brief An index that is replaced as a whole, read-copy-update style.
+ *
+ * The current version is an immutable index, published through an atomic pointer
+ * to its shared_ptr. acquire() registers the reader under the current epoch, copies
+ * that shared_ptr and leaves: a few atomic operations, never a lock and never a
+ * wait for a writer (it retries only if an epoch ends in between). The reader keeps
+ * its version for as long as it holds the copy.
+ *
+ * A writer builds the next version off to the side (from scratch, or from a copy of
+ * the current one) and publishes it with one atomic exchange, so readers see either
+ * the old version or the new one, never a half-built index. It then ends the epoch
+ * and waits out the grace period (readers still inside acquire() under the old
+ * epoch) before dropping its reference to the old version; each old version is
+ * freed when the last reader holding it lets go. Writers are serialized with each
+ * other; a build that throws publishes nothing.
+ */
+template <typename Traits>
+class BasicVersionedIndex {
+public:
+    using indexer_type = BasicIndexer<Traits>;
+    using snapshot_type = std::shared_ptr<const indexer_type>;
+    using builder_type = std::function<void(indexer_type&)>;
+
+    struct Stats {
+        std::uint64_t generation = 0;  // Versions published after the initial one
+        std::uint64_t live = 0;        // Versions not yet reclaimed, current included
+    };
+
+private:
+    std::atomic<const snapshot_type*> current;
+    // Readers inside acquire(), by parity of the epoch they entered under
+    mutable std::atomic<std::uint64_t> epoch{0};
+    mutable std::array<std::atomic<std::uint64_t>, 2> readers{};
+    std::mutex writer;  // Held while a version is built and published
+    std::atomic<std::uint64_t> generation{0};
+    // Shared with the versions' deleters, which may run after this object is gone
+    std::shared_ptr<std::atomic<std::uint64_t>> live;
+
+    snapshot_type adopt(indexer_type&& index) const;
+    // Publish next; caller holds writer
+    std::uint64_t install(indexer_type&& next);
+
+public:
+    explicit BasicVersionedIndex(indexer_type initial = indexer_type());
+
+    BasicVersionedIndex(const BasicVersionedIndex& other) = delete;
+    BasicVersionedIndex& operator=(const BasicVersionedIndex& other) = delete;
+
+    ~BasicVersionedIndex();
+
+    // The current version; it stays valid (and unchanged) while the pointer is held
+    snapshot_type acquire() const;
+
+    // Replace the current version with next; returns the new generation
+    std::uint64_t publish(indexer_type next);
+    // Build a new version from an empty index with the current positional and case modes
+    std::uint64_t rebuild(const builder_type& build);
+    // Edit a copy of the current version and publish it (copy-on-write)
+    std::uint64_t update(const builder_type& edit);
+
+    Stats getStats() const;
+};
+
+using VersionedIndex = BasicVersionedIndex<CompactIndexTraits>;
+using LargeVersionedIndex = BasicVersionedIndex<LargeIndexTraits>;
+
+extern template class BasicVersionedIndex<CompactIndexTraits>;
+extern template class BasicVersionedIndex<LargeIndexTraits>;
+
+#endif // VERSIONED_INDEX_H
@@ -0,0 +1,93 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "WildcardPattern.h"
+
+// Compile: split on '*' and record the literal prefix
+WildcardPattern::WildcardPattern(const std::string& pattern) : pattern(pattern) {
+    size_t firstWildcard = pattern.find_first_of("*?");
+    literalPrefix = pattern.substr(0, firstWildcard);
+
+    leadingStar = !pattern.empty() && pattern.front() == '*';
+    trailingStar = !pattern.empty() && pattern.back() == '*';
+
+    std::string current;
+    for (char c : pattern) {
+        if (c == '*') {
+            if (!current.empty()) {
+                segments.push_back(current);
+                current.clear();
+            }
+        } else {
+            current += c;
+        }
+    }
+    if (!current.empty()) {
+        segments.push_back(current);
+    }
+}
+
+const std::string& WildcardPattern::prefix() const {
+    return literalPrefix;
+}
+
+bool WildcardPattern::hasWildcards() const {
+    return pattern.find_first_of("*?") != std::string::npos;
+}
+
+const std::string& WildcardPattern::getPattern() const {
+    return pattern;
+}
+
+bool WildcardPattern::segmentMatchesAt(const std::string& segment, std::string_view text, size_t offset) {
+    if (offset + segment.size() > text.size()) return false;
+    for (size_t i = 0; i < segment.size(); ++i) {
+        if (segment[i] != '?' && segment[i] != text[offset + i]) return false;
+    }
+    return true;
+}
+
+// Anchored first and last segments; the middle ones take their leftmost match,
+// which is always safe because a '*' sits on both sides of them
+bool WildcardPattern::matches(std::string_view text) const {
+    if (segments.empty()) {
+        // "" matches only "", any run of stars matches everything
+        return leadingStar || text.empty();
+    }
+
+    size_t first = 0;
+    size_t last = segments.size();
+    size_t begin = 0;
+    size_t end = text.size();
+
+    if (!leadingStar) {
+        if (!segmentMatchesAt(segments.front(), text, 0)) return false;
+        begin = segments.front().size();
+        ++first;
+    }
+    if (!trailingStar && first < last) {
+        const std::string& tail = segments.back();
+        if (tail.size() > end - begin || !segmentMatchesAt(tail, text, end - tail.size())) return false;
+        end -= tail.size();
+        --last;
+    }
+    if (first == last) {
+        // Nothing left to place: without a star the text must be used up exactly
+        return leadingStar || trailingStar || segments.size() > 1 ? begin <= end : begin == end;
+    }
+
+    for (size_t i = first; i < last; ++i) {
+        const std::string& segment = segments[i];
+        bool placed = false;
+        for (size_t offset = begin; offset + segment.size() <= end; ++offset) {
+            if (segmentMatchesAt(segment, text, offset)) {
+                begin = offset + segment.size();
+                placed = true;
+                break;
+            }
+        }
+        if (!placed) return false;
+    }
+    return true;
+}
@@ -0,0 +1,60 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#ifndef WILDCARD_PATTERN_H
+#define WILDCARD_PATTERN_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @class WildcardPattern
+ * @brief A glob pattern ('*' = any run of characters, '?' = exactly one)
+ * compiled once into its literal prefix and '*'-separated segments.
+ *
+ * The literal prefix lets the index narrow candidates to one sorted range;
+ * matches() then checks the segments left to right without backtracking.
+ */
+class WildcardPattern {
+private:
+    std::string pattern;                 // Original pattern text
+    std::string literalPrefix;           // Characters before the first wildcard
+    std::vector<std::string> segments;   // Pattern split on '*'
+    bool leadingStar = false;            // Pattern starts with '*'
+    bool trailingStar = false;           // Pattern ends with '*'
+
+    // Does segment match text at offset (segment may contain '?')
+    static bool segmentMatchesAt(const std::string& segment, std::string_view text, size_t offset);
+
+public:
+    // Compile a pattern
+    explicit WildcardPattern(const std::string& pattern);
+
+    // Rule of Five - plain value type
+    WildcardPattern(const WildcardPattern& other) = default;
+    WildcardPattern(WildcardPattern&& other) noexcept = default;
+    WildcardPattern& operator=(const WildcardPattern& other) = default;
+    WildcardPattern& operator=(WildcardPattern&& other) noexcept = default;
+    ~WildcardPattern() = default;
+
+    /**
+     * @brief Literal text every match starts with (may be empty)
+     */
+    const std::string& prefix() const;
+
+    /**
+     * @brief True if the pattern contains '*' or '?'
+     */
+    bool hasWildcards() const;
+
+    /**
+     * @brief Test a whole token against the pattern
+     */
+    bool matches(std::string_view text) const;
+
+    const std::string& getPattern() const;
+};
+
+#endif // WILDCARD_PATTERN_H
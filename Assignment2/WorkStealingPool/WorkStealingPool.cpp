@@ -0,0 +1,128 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "WorkStealingPool.h"
+
+namespace {
+    // The pool and worker index of the calling thread, if it is a worker
+    thread_local const WorkStealingPool* currentPool = nullptr;
+    thread_local size_t currentWorker = 0;
+} // namespace
+
+// Constructor - starts the workers
+WorkStealingPool::WorkStealingPool(size_t threadCount) : started(std::chrono::steady_clock::now()) {
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 1;
+    }
+    workerCount = threadCount;
+    queues = std::make_unique<Worker[]>(workerCount);
+    threads.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        threads.emplace_back(&WorkStealingPool::workerLoop, this, i);
+    }
+}
+
+// Destructor - drains the deques and joins
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    workReady.notify_all();
+    for (auto it = threads.begin(); it != threads.end(); ++it) {
+        it->join();
+    }
+}
+
+void WorkStealingPool::submit(std::function<void()> task) {
+    size_t target = currentPool == this ? currentWorker : nextQueue.fetch_add(1) % workerCount;
+    outstanding.fetch_add(1);
+    {
+        std::lock_guard<std::mutex> lock(queues[target].mutex);
+        queues[target].tasks.push_back(std::move(task));
+    }
+    queued.fetch_add(1);
+    // Taking the lock orders this with a worker that is about to sleep
+    { std::lock_guard<std::mutex> lock(sleepMutex); }
+    workReady.notify_one();
+}
+
+void WorkStealingPool::waitIdle() {
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    idle.wait(lock, [this] { return outstanding.load() == 0; });
+}
+
+size_t WorkStealingPool::size() const {
+    return workerCount;
+}
+
+std::vector<WorkStealingPool::WorkerStats> WorkStealingPool::getStats() const {
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - started);
+    std::vector<WorkerStats> stats(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        stats[i].tasks = queues[i].tasksRun.load(std::memory_order_relaxed);
+        stats[i].steals = queues[i].steals.load(std::memory_order_relaxed);
+        stats[i].busy = std::chrono::nanoseconds(queues[i].busyNanos.load(std::memory_order_relaxed));
+        if (elapsed.count() > 0) {
+            stats[i].utilization = static_cast<double>(stats[i].busy.count()) / static_cast<double>(elapsed.count());
+        }
+    }
+    return stats;
+}
+
+bool WorkStealingPool::takeTask(size_t self, std::function<void()>& task) {
+    {
+        Worker& own = queues[self];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            queued.fetch_sub(1);
+            return true;
+        }
+    }
+    // Victims are tried in order starting after self, so thieves spread out
+    for (size_t i = 1; i < workerCount; ++i) {
+        Worker& victim = queues[(self + i) % workerCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued.fetch_sub(1);
+            queues[self].steals.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+// Take tasks until shutdown; queued tasks are still run after stopping is set
+void WorkStealingPool::workerLoop(size_t self) {
+    currentPool = this;
+    currentWorker = self;
+    Worker& worker = queues[self];
+    while (true) {
+        std::function<void()> task;
+        if (!takeTask(self, task)) {
+            std::unique_lock<std::mutex> lock(sleepMutex);
+            workReady.wait(lock, [this] { return stopping || queued.load() > 0; });
+            if (queued.load() == 0) return;  // stopping and nothing left
+            continue;
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        task();
+        task = nullptr;  // Release what the task captured before it counts as finished
+        worker.busyNanos.fetch_add(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count(),
+            std::memory_order_relaxed);
+        worker.tasksRun.fetch_add(1, std::memory_order_relaxed);
+
+        if (outstanding.fetch_sub(1) == 1) {
+            std::lock_guard<std::mutex> lock(sleepMutex);
+            idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,101 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#ifndef WORK_STEALING_POOL_H
+#define WORK_STEALING_POOL_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @class WorkStealingPool
+ * @brief Worker threads with a task deque each; idle workers steal from the others.
+ *
+ * A task submitted from one of the pool's own workers goes on that worker's deque,
+ * which it drains newest first (the data it just touched is still in cache); other
+ * tasks are dealt round-robin. A worker whose deque is empty takes the oldest task
+ * of another worker's deque, so a task that fans out into many subtasks is shared
+ * out without any up-front partitioning.
+ *
+ * Tasks must not throw; wrap work that can fail and record the error instead.
+ */
+class WorkStealingPool {
+public:
+    struct WorkerStats {
+        std::uint64_t tasks = 0;          // Tasks run by this worker
+        std::uint64_t steals = 0;         // Of which taken from another worker's deque
+        std::chrono::nanoseconds busy{0}; // Time spent running tasks
+        double utilization = 0.0;         // busy / time since the pool started
+    };
+
+private:
+    // Aligned so that neighbouring workers' deques do not share a cache line
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;  // Owner at the back, thieves at the front
+        std::atomic<std::uint64_t> tasksRun{0};
+        std::atomic<std::uint64_t> steals{0};
+        std::atomic<std::int64_t> busyNanos{0};
+    };
+
+    std::unique_ptr<Worker[]> queues;
+    size_t workerCount;
+    std::vector<std::thread> threads;
+    std::chrono::steady_clock::time_point started;
+
+    std::atomic<size_t> queued{0};       // Tasks sitting in some deque
+    std::atomic<size_t> outstanding{0};  // Tasks queued or running
+    std::atomic<size_t> nextQueue{0};    // Round-robin target for outside submissions
+    std::mutex sleepMutex;
+    std::condition_variable workReady;  // Signalled when a task is queued or on shutdown
+    std::condition_variable idle;       // Signalled when the last outstanding task finishes
+    bool stopping = false;
+
+    void workerLoop(size_t self);
+    // Newest task of the worker's own deque, else the oldest of another's
+    bool takeTask(size_t self, std::function<void()>& task);
+
+public:
+    /**
+     * @brief Start threadCount workers (0 = one per hardware thread)
+     */
+    explicit WorkStealingPool(size_t threadCount = 0);
+
+    // Workers hold a pointer to the pool: not copyable or movable
+    WorkStealingPool(const WorkStealingPool& other) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool& other) = delete;
+    WorkStealingPool(WorkStealingPool&& other) = delete;
+    WorkStealingPool& operator=(WorkStealingPool&& other) = delete;
+
+    /**
+     * @brief Finishes the queued tasks (and any they submit), then joins the workers
+     */
+    ~WorkStealingPool();
+
+    /**
+     * @brief Queue a task: on the calling worker's own deque, or round-robin from outside the pool
+     */
+    void submit(std::function<void()> task);
+
+    /**
+     * @brief Block until no task is queued or running
+     */
+    void waitIdle();
+
+    size_t size() const;
+
+    // Per-worker counters since the pool started
+    std::vector<WorkerStats> getStats() const;
+};
+
+#endif // WORK_STEALING_POOL_H
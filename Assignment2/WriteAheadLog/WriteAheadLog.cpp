@@ -0,0 +1,246 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+//
+
+#include "WriteAheadLog.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../ByteCoding/ByteCoding.h"
+#include "../IndexFile/IndexFile.h"
+
+namespace {
+
+    std::runtime_error systemError(const std::string& what, const std::string& path) {
+        return std::runtime_error(what + " '" + path + "': " + std::strerror(errno));
+    }
+
+    // Lines of one record payload; false if the payload is malformed
+    bool decodePayload(std::string_view payload, std::vector<WriteAheadLog::Line>& lines) {
+        const char* data = payload.data();
+        size_t end = payload.size();
+        size_t offset = 0;
+        while (offset < end) {
+            WriteAheadLog::Line line;
+            std::uint64_t tokenCount = 0;
+            if (!readVarint(data, end, offset, line.number) || !readVarint(data, end, offset, tokenCount) ||
+                tokenCount > end - offset) {
+                return false;
+            }
+            line.tokens.reserve(static_cast<size_t>(tokenCount));
+            for (std::uint64_t t = 0; t < tokenCount; ++t) {
+                std::uint64_t length = 0;
+                if (!readVarint(data, end, offset, length) || length > end - offset) {
+                    return false;
+                }
+                line.tokens.emplace_back(payload.substr(offset, static_cast<size_t>(length)));
+                offset += static_cast<size_t>(length);
+            }
+            lines.push_back(std::move(line));
+        }
+        return true;
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open write-ahead log: " + path);
+        }
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    bool hasHeader(std::string_view image) {
+        if (image.size() < WriteAheadLog::HEADER_SIZE ||
+            !std::equal(WriteAheadLog::MAGIC.begin(), WriteAheadLog::MAGIC.end(), image.begin())) {
+            return false;
+        }
+        return readWord<std::uint32_t>(image.data() + WriteAheadLog::MAGIC.size()) == WriteAheadLog::VERSION;
+    }
+
+    /**
+     * Walks the records after the header, passing each complete one to apply (if any).
+     * Returns the offset just past the last complete record.
+     */
+    size_t scanRecords(std::string_view image, const std::function<void(const WriteAheadLog::Line&)>* apply,
+                       std::uint64_t& records) {
+        size_t offset = WriteAheadLog::HEADER_SIZE;
+        std::vector<WriteAheadLog::Line> lines;
+        while (image.size() - offset >= WriteAheadLog::RECORD_HEADER_SIZE) {
+            std::uint32_t size = readWord<std::uint32_t>(image.data() + offset);
+            std::uint64_t checksum = readWord<std::uint64_t>(image.data() + offset + 8);
+            if (size > image.size() - offset - WriteAheadLog::RECORD_HEADER_SIZE) {
+                break;  // torn: the payload never made it to disk
+            }
+            std::string_view payload = image.substr(offset + WriteAheadLog::RECORD_HEADER_SIZE, size);
+            lines.clear();
+            if (IndexFile::checksum(payload.data(), payload.size()) != checksum || !decodePayload(payload, lines)) {
+                break;
+            }
+            // A record is applied whole or not at all
+            if (apply != nullptr) {
+                for (auto it = lines.cbegin(); it != lines.cend(); ++it) {
+                    (*apply)(*it);
+                }
+            }
+            ++records;
+            offset += WriteAheadLog::RECORD_HEADER_SIZE + size;
+        }
+        return offset;
+    }
+
+} // namespace
+
+// Constructor - opens for appending after the last complete record
+WriteAheadLog::WriteAheadLog(const std::string& path, size_t syncEvery) : path(path), syncEvery(syncEvery) {
+    fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        throw systemError("Could not open write-ahead log", path);
+    }
+    try {
+        std::string image = readFile(path);
+        size_t end = 0;
+        if (hasHeader(image)) {
+            std::uint64_t records = 0;
+            end = scanRecords(image, nullptr, records);
+        } else if (image.size() >= HEADER_SIZE) {
+            throw std::runtime_error("Not a write-ahead log: " + path);
+        }
+        // else empty, or a header cut short while the log was being created
+
+        if (end != image.size() && ::ftruncate(fd, static_cast<off_t>(end)) != 0) {
+            throw systemError("Could not truncate write-ahead log", path);
+        }
+        if (end == 0) {
+            std::string header(MAGIC.begin(), MAGIC.end());
+            appendWord(header, VERSION);
+            appendWord(header, std::uint32_t{0});
+            if (::pwrite(fd, header.data(), header.size(), 0) != static_cast<ssize_t>(header.size()) ||
+                ::fdatasync(fd) != 0) {
+                throw systemError("Could not write write-ahead log", path);
+            }
+            end = header.size();
+        }
+        if (::lseek(fd, static_cast<off_t>(end), SEEK_SET) < 0) {
+            throw systemError("Could not seek write-ahead log", path);
+        }
+        stats.bytes = end;
+    } catch (...) {
+        close();
+        throw;
+    }
+}
+
+// Move constructor
+WriteAheadLog::WriteAheadLog(WriteAheadLog&& other) noexcept
+    : fd(other.fd), path(std::move(other.path)), syncEvery(other.syncEvery), unsynced(other.unsynced),
+      stats(other.stats) {
+    other.fd = -1;
+}
+
+// Move assignment operator
+WriteAheadLog& WriteAheadLog::operator=(WriteAheadLog&& other) noexcept {
+    if (this != &other) {
+        close();
+        fd = other.fd;
+        path = std::move(other.path);
+        syncEvery = other.syncEvery;
+        unsynced = other.unsynced;
+        stats = other.stats;
+        other.fd = -1;
+    }
+    return *this;
+}
+
+// Destructor
+WriteAheadLog::~WriteAheadLog() {
+    close();
+}
+
+void WriteAheadLog::close() {
+    if (fd >= 0) {
+        if (unsynced != 0) {
+            ::fdatasync(fd);
+        }
+        ::close(fd);
+        fd = -1;
+    }
+}
+
+void WriteAheadLog::append(const std::vector<Line>& batch) {
+    std::string record(RECORD_HEADER_SIZE, '\0');
+    for (auto line = batch.cbegin(); line != batch.cend(); ++line) {
+        appendVarint(record, line->number);
+        appendVarint(record, line->tokens.size());
+        for (auto token = line->tokens.cbegin(); token != line->tokens.cend(); ++token) {
+            appendVarint(record, token->size());
+            record.append(*token);
+        }
+    }
+    size_t payloadSize = record.size() - RECORD_HEADER_SIZE;
+    if (payloadSize > MAX_RECORD_SIZE) {
+        throw std::length_error("WriteAheadLog::append: batch larger than " + std::to_string(MAX_RECORD_SIZE) +
+                                " bytes");
+    }
+    std::uint32_t size = static_cast<std::uint32_t>(payloadSize);
+    std::uint64_t checksum = IndexFile::checksum(record.data() + RECORD_HEADER_SIZE, payloadSize);
+    std::memcpy(record.data(), &size, sizeof(size));
+    std::memcpy(record.data() + 8, &checksum, sizeof(checksum));
+
+    for (size_t written = 0; written < record.size();) {
+        ssize_t n = ::write(fd, record.data() + written, record.size() - written);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) {
+            std::runtime_error error = systemError("Could not append to write-ahead log", path);
+            // Cut off the partial record so later appends still follow a complete one
+            if (::ftruncate(fd, static_cast<off_t>(stats.bytes)) == 0) {
+                ::lseek(fd, static_cast<off_t>(stats.bytes), SEEK_SET);
+            }
+            throw error;
+        }
+        written += static_cast<size_t>(n);
+    }
+    stats.bytes += record.size();
+    ++stats.records;
+    ++unsynced;
+    if (syncEvery != 0 && unsynced >= syncEvery) {
+        sync();
+    }
+}
+
+void WriteAheadLog::sync() {
+    if (unsynced == 0) return;
+    if (::fdatasync(fd) != 0) {
+        throw systemError("Could not sync write-ahead log", path);
+    }
+    unsynced = 0;
+    ++stats.syncs;
+}
+
+const std::string& WriteAheadLog::getPath() const {
+    return path;
+}
+
+WriteAheadLog::Stats WriteAheadLog::getStats() const {
+    return stats;
+}
+
+std::uint64_t WriteAheadLog::replay(const std::string& path, const std::function<void(const Line&)>& apply) {
+    std::string image = readFile(path);
+    std::uint64_t records = 0;
+    if (!hasHeader(image)) {
+        if (image.size() >= HEADER_SIZE) {
+            throw std::runtime_error("Not a write-ahead log: " + path);
+        }
+        return 0;  // created but never written
+    }
+    scanRecords(image, &apply, records);
+    return records;
+}
@@ -0,0 +1,90 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Append-only log of indexed lines, replayed after a crash
+//
+
+#ifndef WRITE_AHEAD_LOG_H
+#define WRITE_AHEAD_LOG_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @class WriteAheadLog
+ * @brief Batches of (line number, tokens) appended to a file, each batch one record.
+ *
+ * Layout: MAGIC, u32 VERSION, u32 reserved, then records of
+ *   u32 payload size, u32 reserved, u64 checksum of the payload, payload
+ * where the payload is, per line, varint line number, varint token count and
+ * each token as varint length + bytes. A record is complete only once all of
+ * it is on disk, so a crash can leave at most one torn record at the end;
+ * replay stops there and reopening the log cuts it off.
+ *
+ * Records reach the disk (fdatasync) every syncEvery appends, or on sync().
+ * Linux / POSIX only.
+ */
+class WriteAheadLog {
+public:
+    static constexpr std::array<char, 8> MAGIC = {'C', '5', '4', '2', '1', 'W', 'A', 'L'};
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 16;
+    static constexpr size_t RECORD_HEADER_SIZE = 16;
+    static constexpr size_t MAX_RECORD_SIZE = 1u << 30;
+
+    struct Line {
+        std::uint64_t number = 0;
+        std::vector<std::string> tokens;
+    };
+
+    struct Stats {
+        std::uint64_t records = 0;  // Appended since the log was opened
+        std::uint64_t bytes = 0;    // Size of the log file
+        std::uint64_t syncs = 0;
+    };
+
+private:
+    int fd = -1;
+    std::string path;
+    size_t syncEvery;
+    size_t unsynced = 0;  // Records appended since the last sync
+    Stats stats;
+
+    void close();
+
+public:
+    /**
+     * @brief Open the log at path for appending, creating it if needed. An existing
+     * log is checked and a torn last record is truncated away. syncEvery = 0 leaves
+     * flushing to the operating system (and sync()). Throws std::runtime_error.
+     */
+    explicit WriteAheadLog(const std::string& path, size_t syncEvery = 1);
+
+    WriteAheadLog(const WriteAheadLog& other) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog& other) = delete;
+    WriteAheadLog(WriteAheadLog&& other) noexcept;
+    WriteAheadLog& operator=(WriteAheadLog&& other) noexcept;
+
+    ~WriteAheadLog();  // syncs outstanding records
+
+    // Append one batch as a single record
+    void append(const std::vector<Line>& batch);
+
+    // Force appended records to disk
+    void sync();
+
+    const std::string& getPath() const;
+    Stats getStats() const;
+
+    /**
+     * @brief Apply every complete record of the log at path, line by line, in order.
+     * Returns the number of records applied; stops quietly at a torn or damaged tail.
+     * Throws std::runtime_error if the file is not a log.
+     */
+    static std::uint64_t replay(const std::string& path, const std::function<void(const Line&)>& apply);
+};
+
+#endif // WRITE_AHEAD_LOG_H
@@ -1,7 +1,91 @@
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "CorpusIndexer/CorpusIndexer.h"
 #include "IndexerUI/IndexerUI.h"
+#include "QueryServer/QueryServer.h"
+
+namespace {
+
+    QueryServer* activeServer = nullptr;  // Stopped by SIGINT / SIGTERM
+
+    void stopServer(int) {
+        if (activeServer != nullptr) activeServer->stop();
+    }
+
+    int serveUsage(const char* program) {
+        std::cerr << "Usage: " << program << " --serve <socket path> [--threads N]"
+                  << " (--load <index file> | --index <text file>...)\n";
+        return 1;
+    }
+
+    // Server mode: build or load the index once, then answer queries on a Unix socket
+    int serve(int argc, char** argv) {
+        std::string socketPath = argv[2];
+        std::string loadPath;
+        std::vector<std::string> textFiles;
+        size_t threads = 0;
+        for (int i = 3; i < argc; ++i) {
+            std::string option = argv[i];
+            if (option == "--threads" && i + 1 < argc) {
+                threads = std::strtoul(argv[++i], nullptr, 10);
+            } else if (option == "--load" && i + 1 < argc) {
+                loadPath = argv[++i];
+            } else if (option == "--index") {
+                while (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+                    textFiles.push_back(argv[++i]);
+                }
+            } else {
+                return serveUsage(argv[0]);
+            }
+        }
+        if (loadPath.empty() == textFiles.empty()) return serveUsage(argv[0]);
+
+        try {
+            Indexer index;
+            if (!loadPath.empty()) {
+                index.load(loadPath);
+            } else {
+                CorpusOptions options;
+                options.positional = true;  // keeps word positions for phrase and NEAR queries
+                index = CorpusIndexer(options).indexFiles(textFiles);
+            }
+            std::cout << "Index ready (" << index.getLineCount() << " lines, " << index.getTokenCount()
+                      << " tokens)." << std::endl;
+
+            VersionedIndex versions(std::move(index));
+            QueryServer server(socketPath, versions, threads);
+            activeServer = &server;
+            std::signal(SIGINT, stopServer);
+            std::signal(SIGTERM, stopServer);
+            std::cout << "Serving queries on " << socketPath << std::endl;
+            server.run();
+            activeServer = nullptr;
+
+            QueryServer::Stats stats = server.getStats();
+            std::cout << "Server stopped after " << stats.requests << " requests on " << stats.connections
+                      << " connections." << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+
+} // namespace
+
 // TIP To <b>Run</b> code, press <shortcut actionId="Run"/> or click the <icon src="AllIcons.Actions.Execute"/> icon in the gutter.
-int main() {
+int main(int argc, char** argv) {
+    if (argc > 2 && std::string(argv[1]) == "--serve") {
+        return serve(argc, argv);
+    }
+    if (argc > 1) {
+        return serveUsage(argv[0]);
+    }
+
     std::cout << "Starting Text File Indexer\n";
     IndexerUI indexer_ui;;
     indexer_ui.run();
@@ -0,0 +1,141 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Benchmark: ConcurrentIndexer ingest throughput at 1-64 threads on Zipf-skewed text,
+// one global lock against a lock per section and striped sections
+//
+// Usage: COMP5421_ContentionBenchmark [lines] [max threads]
+//
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ConcurrentIndexer/ConcurrentIndexer.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    const size_t VOCABULARY = 20000;
+    const size_t TOKENS_PER_LINE = 12;
+    const size_t LINES_PER_CLAIM = 8;
+
+    // Lines of words drawn with Zipf(1.0) frequencies; hotSection puts every word in 't'
+    std::vector<std::string> makeLines(size_t lineCount, bool hotSection) {
+        std::mt19937 random(5421);
+        std::vector<std::string> words;
+        std::uniform_int_distribution<int> letter(0, 25);
+        std::uniform_int_distribution<int> length(2, 9);
+        for (size_t i = 0; i < VOCABULARY; ++i) {
+            std::string word = hotSection ? "t" : "";
+            for (int n = length(random); n > 0; --n) {
+                word += static_cast<char>('a' + letter(random));
+            }
+            words.push_back(word + std::to_string(i));
+        }
+        std::vector<double> cumulative;
+        double total = 0;
+        for (size_t rank = 1; rank <= VOCABULARY; ++rank) {
+            total += 1.0 / static_cast<double>(rank);
+            cumulative.push_back(total);
+        }
+        std::uniform_real_distribution<double> pick(0, total);
+        std::vector<std::string> lines;
+        for (size_t i = 0; i < lineCount; ++i) {
+            std::string line;
+            for (size_t t = 0; t < TOKENS_PER_LINE; ++t) {
+                auto rank = std::lower_bound(cumulative.begin(), cumulative.end(), pick(random)) - cumulative.begin();
+                line += words[static_cast<size_t>(rank)];
+                line += ' ';
+            }
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+    std::string dump(const Indexer& index) {
+        std::ostringstream out;
+        index.print(out);
+        return out.str();
+    }
+
+    std::string dump(const ConcurrentIndexer& index) {
+        std::ostringstream out;
+        index.print(out);
+        return out.str();
+    }
+
+    // Threads claim runs of lines from a shared counter, so lines arrive out of order
+    double ingest(ConcurrentIndexer& index, const std::vector<std::string>& lines, size_t threads,
+                  std::mutex* globalLock) {
+        std::atomic<size_t> next{0};
+        auto start = Clock::now();
+        std::vector<std::thread> workers;
+        for (size_t w = 0; w < threads; ++w) {
+            workers.emplace_back([&] {
+                for (size_t first = next.fetch_add(LINES_PER_CLAIM); first < lines.size();
+                     first = next.fetch_add(LINES_PER_CLAIM)) {
+                    size_t last = std::min(first + LINES_PER_CLAIM, lines.size());
+                    for (size_t i = first; i < last; ++i) {
+                        if (globalLock) {
+                            std::lock_guard<std::mutex> lock(*globalLock);
+                            index.processLine(lines[i], static_cast<Indexer::line_type>(i + 1));
+                        } else {
+                            index.processLine(lines[i], static_cast<Indexer::line_type>(i + 1));
+                        }
+                    }
+                }
+            });
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        return std::chrono::duration<double>(Clock::now() - start).count();
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t lineCount = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000;
+    size_t maxThreads = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 64;
+    std::cout << "hardware threads: " << std::thread::hardware_concurrency() << "\n";
+
+    const bool distributions[] = {false, true};
+    for (bool hotSection : distributions) {
+        std::vector<std::string> lines = makeLines(lineCount, hotSection);
+        Indexer sequential;
+        for (const std::string& line : lines) {
+            sequential.processLine(line);
+        }
+        std::string expected = dump(sequential);
+
+        std::cout << "\n" << (hotSection ? "one hot section ('t')" : "zipf over all sections") << ", " << lineCount
+                  << " lines, k lines/s\n"
+                  << std::left << std::setw(10) << "threads" << std::setw(14) << "global lock" << std::setw(14)
+                  << "per section" << "8 stripes/section\n"
+                  << std::fixed << std::setprecision(1);
+        for (size_t threads = 1; threads <= maxThreads; threads *= 2) {
+            std::cout << std::setw(10) << threads;
+            for (int variant = 0; variant < 3; ++variant) {
+                ConcurrentIndexer index(variant == 2 ? 8 : 1);
+                std::mutex globalLock;
+                double seconds = ingest(index, lines, threads, variant == 0 ? &globalLock : nullptr);
+                if (dump(index) != expected) {
+                    std::cout << "\nMISMATCH: concurrent index differs from the sequential one\n";
+                    return 1;
+                }
+                std::cout << std::setw(variant == 2 ? 0 : 14) << static_cast<double>(lines.size()) / seconds / 1000;
+            }
+            std::cout << "\n";
+        }
+    }
+    return 0;
+}
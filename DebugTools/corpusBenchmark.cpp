@@ -0,0 +1,93 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Benchmark: indexing a multi-file corpus sequentially, in pieces no smaller than the
+// largest file (no file is split), and in work-stolen chunks, with per-worker tasks, steals and utilization
+//
+// Usage: COMP5421_CorpusBenchmark <threads> <chunk KiB> <text file>...
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CorpusIndexer/CorpusIndexer.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::string dump(const Indexer& index) {
+        std::ostringstream out;
+        index.print(out);
+        return out.str();
+    }
+
+    void report(const char* name, double ms, const CorpusIndexer::Stats& stats) {
+        std::cout << "\n" << name << ": " << ms << " ms, " << stats.pieces << " pieces, " << stats.merges
+                  << " merges\n"
+                  << std::setw(10) << "worker" << std::setw(10) << "tasks" << std::setw(10) << "steals"
+                  << "utilization\n";
+        for (size_t i = 0; i < stats.workers.size(); ++i) {
+            const WorkStealingPool::WorkerStats& worker = stats.workers[i];
+            std::cout << std::setw(10) << i << std::setw(10) << worker.tasks << std::setw(10) << worker.steals
+                      << worker.utilization * 100 << "%\n";
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 4) {
+        std::cerr << "Usage: " << argv[0] << " <threads> <chunk KiB> <text file>...\n";
+        return 1;
+    }
+    size_t threads = std::strtoul(argv[1], nullptr, 10);
+    std::uint64_t chunkBytes = std::strtoull(argv[2], nullptr, 10) * 1024;
+    std::vector<std::string> paths(argv + 3, argv + argc);
+    std::cout << std::left << std::fixed << std::setprecision(1) << paths.size() << " files\n";
+
+    auto start = Clock::now();
+    Indexer sequential;
+    for (const std::string& path : paths) {
+        std::ifstream file(path);
+        std::string line;
+        while (std::getline(file, line)) {
+            sequential.processLine(line);
+        }
+    }
+    std::cout << "\nsequential: " << millisecondsSince(start) << " ms, " << sequential.getLineCount() << " lines\n";
+    std::string expected = dump(sequential);
+
+    // No file split: the piece holding the largest file bounds the run
+    CorpusOptions options;
+    options.threads = threads;
+    options.chunkBytes = 1;
+    for (const std::string& path : paths) {
+        options.chunkBytes = std::max<std::uint64_t>(options.chunkBytes, std::filesystem::file_size(path));
+    }
+    CorpusIndexer wholeFiles(options);
+    start = Clock::now();
+    Indexer whole = wholeFiles.indexFiles(paths);
+    report("whole files", millisecondsSince(start), wholeFiles.getStats());
+
+    options.chunkBytes = chunkBytes;
+    CorpusIndexer chunked(options);
+    start = Clock::now();
+    Indexer stolen = chunked.indexFiles(paths);
+    report("chunked, work stealing", millisecondsSince(start), chunked.getStats());
+
+    if (dump(whole) != expected || dump(stolen) != expected) {
+        std::cout << "MISMATCH: parallel index differs from the sequential one\n";
+        return 1;
+    }
+    return 0;
+}
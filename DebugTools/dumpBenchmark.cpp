@@ -0,0 +1,72 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Benchmark: full-index dump throughput (Indexer::print and printParallel to a file)
+//
+// Usage: COMP5421_DumpBenchmark <text file> [output file] [repetitions]
+//
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include "Indexer/Indexer.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <text file> [output file] [repetitions]\n";
+        return 1;
+    }
+    std::string outputFile = argc > 2 ? argv[2] : "dumpBenchmark.out";
+    int repetitions = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    Indexer index;
+    index.processTextFile(argv[1]);
+
+    // Best-of-N time of one dump into outputFile; returns (ms, bytes)
+    auto timeDump = [&](auto dump) {
+        double best = 0.0;
+        std::streamoff bytes = 0;
+        for (int i = 0; i < repetitions; ++i) {
+            std::ofstream out(outputFile, std::ios::binary | std::ios::trunc);
+            auto start = Clock::now();
+            dump(out);
+            out.flush();
+            double elapsed = millisecondsSince(start);
+            bytes = out.tellp();
+            if (i == 0 || elapsed < best) best = elapsed;
+        }
+        return std::make_pair(best, bytes);
+    };
+    auto report = [&](const std::string& label, std::pair<double, std::streamoff> result) {
+        double megabytes = static_cast<double>(result.second) / (1024.0 * 1024.0);
+        std::cout << std::fixed << std::setprecision(1) << label << megabytes << " MiB in " << result.first
+                  << " ms (best of " << repetitions << "), " << megabytes / (result.first / 1000.0) << " MiB/s\n";
+    };
+
+    report("Dump:          ", timeDump([&](std::ostream& out) { index.print(out); }));
+    std::ostringstream serial;
+    index.print(serial);
+
+    for (size_t threads : {1u, 2u, 4u, 8u}) {
+        report("Parallel (" + std::to_string(threads) + "):  ",
+               timeDump([&](std::ostream& out) { index.printParallel(out, threads); }));
+        std::ostringstream parallel;
+        index.printParallel(parallel, threads);
+        if (parallel.str() != serial.str()) {
+            std::cout << "  MISMATCH with the serial dump\n";
+        }
+    }
+    return 0;
+}
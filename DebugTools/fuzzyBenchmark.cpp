@@ -0,0 +1,103 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Benchmark: Indexer::findSimilar (BK-tree) against a linear edit-distance scan
+//
+// Usage: COMP5421_FuzzyBenchmark [dictionary size] [queries]
+//
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include "Indexer/Indexer.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Pronounceable random words so that the dictionary has realistic near neighbours
+    std::string randomWord(std::mt19937& rng) {
+        static const char* syllables[] = {"con", "nect", "ion", "er", "ror", "time", "out", "re", "try",
+                                          "ser", "ver", "log", "in", "data", "base", "ka", "fka", "ku",
+                                          "be", "pro", "cess", "ed", "ing", "s", "t", "a", "o"};
+        std::uniform_int_distribution<int> count(1, 4);
+        std::uniform_int_distribution<size_t> pick(0, std::size(syllables) - 1);
+        std::string word;
+        for (int i = count(rng); i > 0; --i) {
+            word += syllables[pick(rng)];
+        }
+        return word;
+    }
+
+    // One random insert, delete or substitution
+    std::string typo(std::string word, std::mt19937& rng) {
+        std::uniform_int_distribution<int> kind(0, 2);
+        std::uniform_int_distribution<size_t> at(0, word.size() - 1);
+        char letter = static_cast<char>('a' + rng() % 26);
+        switch (kind(rng)) {
+            case 0: word.insert(word.begin() + static_cast<std::ptrdiff_t>(at(rng)), letter); break;
+            case 1: if (word.size() > 1) word.erase(at(rng), 1); break;
+            default: word[at(rng)] = letter; break;
+        }
+        return word;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    size_t dictionarySize = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000;
+    size_t queryCount = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 200;
+
+    std::mt19937 rng(5421);
+    Indexer index;
+    std::vector<std::string> words;
+    for (Indexer::line_type line = 1; words.size() < dictionarySize && line < dictionarySize * 8; ++line) {
+        std::string word = randomWord(rng) + randomWord(rng);
+        if (index.findToken(word) == nullptr) {
+            words.push_back(word);
+        }
+        index.processToken(word, line);
+    }
+    std::vector<const IndexedToken*> dictionary = index.findPrefix("");
+    std::cout << "Dictionary: " << dictionary.size() << " distinct tokens\n";
+
+    auto start = Clock::now();
+    index.findSimilar("warmup", 0);  // builds the BK-tree
+    std::cout << "BK-tree build: " << std::fixed << std::setprecision(1) << millisecondsSince(start) << " ms\n\n";
+
+    std::vector<std::string> queries;
+    for (size_t i = 0; i < queryCount; ++i) {
+        queries.push_back(typo(words[rng() % words.size()], rng));
+    }
+
+    std::cout << std::left << std::setw(4) << "k" << std::setw(18) << "BK-tree ms/query"
+              << std::setw(18) << "scan ms/query" << std::setw(10) << "speedup" << "matches\n";
+    for (size_t k = 1; k <= 3; ++k) {
+        size_t treeMatches = 0;
+        start = Clock::now();
+        for (const std::string& query : queries) {
+            treeMatches += index.findSimilar(query, k).size();
+        }
+        double treeTime = millisecondsSince(start) / static_cast<double>(queries.size());
+
+        size_t scanMatches = 0;
+        start = Clock::now();
+        for (const std::string& query : queries) {
+            for (const IndexedToken* token : dictionary) {
+                if (editDistance(query, token->getKey()) <= k) ++scanMatches;
+            }
+        }
+        double scanTime = millisecondsSince(start) / static_cast<double>(queries.size());
+
+        std::cout << std::setw(4) << k << std::setw(18) << std::setprecision(3) << treeTime
+                  << std::setw(18) << scanTime << std::setw(10) << std::setprecision(1) << scanTime / treeTime
+                  << treeMatches << (treeMatches == scanMatches ? "" : "  (MISMATCH with scan)") << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,117 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Benchmark: startup from a saved index (Indexer::load, MappedIndex) against re-indexing the text
+//
+// Usage: COMP5421_LoadBenchmark <text file> [index file]
+//
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Indexer/Indexer.h"
+#include "FrontCodedDictionary/FrontCodedDictionary.h"
+#include "MappedIndex/MappedIndex.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    // Full dump, every section and a few length views
+    template <typename Index>
+    std::string dump(const Index& index) {
+        std::ostringstream out;
+        index.print(out);
+        for (int i = 0; i < Indexer::NUM_SECTIONS; ++i) {
+            index.displaySection(i, out);
+        }
+        for (size_t length = 0; length < 12; ++length) {
+            index.listByLength(length, out);
+        }
+        return out.str();
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <text file> [index file]\n";
+        return 1;
+    }
+    std::string indexFile = argc > 2 ? argv[2] : "loadBenchmark.idx";
+
+    Indexer built;
+    built.setPositional(true);
+    auto start = Clock::now();
+    built.processTextFile(argv[1]);
+    double indexTime = millisecondsSince(start);
+
+    start = Clock::now();
+    built.save(indexFile);
+    double saveTime = millisecondsSince(start);
+
+    Indexer loaded;
+    start = Clock::now();
+    loaded.load(indexFile);
+    double loadTime = millisecondsSince(start);
+
+    start = Clock::now();
+    MappedIndex mapped(indexFile);
+    double mapTime = millisecondsSince(start);
+
+    // Every token looked up in place
+    std::vector<std::string> tokens;
+    for (const IndexedToken& entry : built.range("", "")) {
+        tokens.push_back(entry.getToken());
+    }
+    size_t found = 0;
+
+    // Dictionary size: keys stored whole against the front-coded section dictionaries
+    size_t rawKeyBytes = 0;
+    size_t codedKeyBytes = 0;
+    std::vector<std::string_view> sectionKeys;
+    int currentSection = -1;
+    for (const IndexedToken& entry : built.range("", "")) {
+        int section = getSectionIndex(entry.getKey()[0]);
+        if (section != currentSection) {
+            codedKeyBytes += sectionKeys.empty() ? 0 : FrontCodedDictionary::encode(sectionKeys).size();
+            sectionKeys.clear();
+            currentSection = section;
+        }
+        sectionKeys.push_back(entry.getKey());
+        rawKeyBytes += entry.getKey().size();
+    }
+    codedKeyBytes += sectionKeys.empty() ? 0 : FrontCodedDictionary::encode(sectionKeys).size();
+
+    start = Clock::now();
+    for (const std::string& token : tokens) {
+        if (mapped.findToken(token)) ++found;
+    }
+    double lookupTime = millisecondsSince(start);
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "processTextFile: " << indexTime << " ms\n"
+              << "save:            " << saveTime << " ms\n"
+              << "load:            " << loadTime << " ms (" << indexTime / loadTime << "x faster than re-indexing)\n"
+              << "map:             " << std::setprecision(3) << mapTime << " ms\n"
+              << "mapped lookups:  " << found << "/" << tokens.size() << " in " << lookupTime << " ms\n"
+              << "dictionary:      " << codedKeyBytes << " bytes front-coded, " << rawKeyBytes << " bytes of keys ("
+              << std::setprecision(2) << static_cast<double>(rawKeyBytes) / static_cast<double>(codedKeyBytes)
+              << "x)\n";
+    std::string expected = dump(built);
+    if (dump(loaded) != expected || !loaded.isPositional()) {
+        std::cout << "MISMATCH: the loaded index differs from the one saved\n";
+        return 1;
+    }
+    if (dump(mapped) != expected || found != tokens.size()) {
+        std::cout << "MISMATCH: the mapped index differs from the one saved\n";
+        return 1;
+    }
+    return 0;
+}
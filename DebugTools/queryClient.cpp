@@ -0,0 +1,70 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Client for the query server: sends query lines, prints the replies
+//
+// Usage: COMP5421_QueryClient <socket path> [--stats] [query line]...
+//        (with no query lines, one query per line is read from standard input)
+//
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unistd.h>
+#include "QueryProtocol/QueryProtocol.h"
+
+namespace {
+
+    // Sends one request and prints its reply; false if the server reported an error
+    bool ask(int fd, std::uint32_t id, QueryProtocol::Type type, const std::string& body) {
+        QueryProtocol::Frame request;
+        request.id = id;
+        request.code = static_cast<std::uint8_t>(type);
+        request.body = body;
+        QueryProtocol::writeFrame(fd, request);
+
+        QueryProtocol::Frame reply;
+        if (!QueryProtocol::readFrame(fd, reply)) {
+            throw std::runtime_error("Query server closed the connection");
+        }
+        if (reply.code != static_cast<std::uint8_t>(QueryProtocol::Status::Ok)) {
+            std::cerr << "Error: " << reply.body << "\n";
+            return false;
+        }
+        std::cout << reply.body << std::flush;
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <socket path> [--stats] [query line]...\n";
+        return 1;
+    }
+    bool ok = true;
+    try {
+        int fd = QueryProtocol::connect(argv[1]);
+        std::uint32_t id = 0;
+        if (argc > 2) {
+            for (int i = 2; i < argc; ++i) {
+                std::string argument = argv[i];
+                if (argument == "--stats") {
+                    ok = ask(fd, ++id, QueryProtocol::Type::Stats, "") && ok;
+                } else {
+                    ok = ask(fd, ++id, QueryProtocol::Type::Query, argument) && ok;
+                }
+            }
+        } else {
+            std::string line;
+            while (std::getline(std::cin, line)) {
+                if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+                ok = ask(fd, ++id, QueryProtocol::Type::Query, line) && ok;
+            }
+        }
+        ::close(fd);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return ok ? 0 : 2;
+}
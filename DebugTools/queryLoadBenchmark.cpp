@@ -0,0 +1,135 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Load generator for the query server: throughput and tail latency with several
+// connections, each keeping a fixed number of requests in flight
+//
+// Usage: COMP5421_QueryLoadBenchmark <socket path> <query file> [connections] [seconds] [depth]
+//        (query file: BatchQueryRunner syntax, one query per line)
+//
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <unistd.h>
+#include "QueryProtocol/QueryProtocol.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct ConnectionResult {
+        std::vector<double> latencies;  // Microseconds per request
+        size_t errors = 0;
+        std::string failure;            // Set if the connection broke
+    };
+
+    double percentile(const std::vector<double>& sorted, double p) {
+        return sorted[static_cast<size_t>(p * static_cast<double>(sorted.size() - 1))];
+    }
+
+    // Keeps depth requests in flight until the deadline, then collects the stragglers
+    void drive(const std::string& socketPath, const std::vector<std::string>& queries, size_t offset, size_t depth,
+               Clock::time_point deadline, ConnectionResult& result) {
+        try {
+            int fd = QueryProtocol::connect(socketPath);
+            std::unordered_map<std::uint32_t, Clock::time_point> sent;
+            std::uint32_t nextId = 0;
+            auto send = [&] {
+                QueryProtocol::Frame request;
+                request.id = nextId++;
+                request.code = static_cast<std::uint8_t>(QueryProtocol::Type::Query);
+                request.body = queries[(offset + request.id) % queries.size()];
+                sent[request.id] = Clock::now();
+                QueryProtocol::writeFrame(fd, request);
+            };
+            for (size_t i = 0; i < depth; ++i) {
+                send();
+            }
+            while (!sent.empty()) {
+                QueryProtocol::Frame reply;
+                if (!QueryProtocol::readFrame(fd, reply)) {
+                    throw std::runtime_error("server closed the connection");
+                }
+                auto found = sent.find(reply.id);
+                if (found == sent.end()) {
+                    throw std::runtime_error("reply to unknown request " + std::to_string(reply.id));
+                }
+                result.latencies.push_back(
+                    std::chrono::duration<double, std::micro>(Clock::now() - found->second).count());
+                sent.erase(found);
+                if (reply.code != static_cast<std::uint8_t>(QueryProtocol::Status::Ok)) ++result.errors;
+                if (Clock::now() < deadline) send();
+            }
+            ::close(fd);
+        } catch (const std::exception& e) {
+            result.failure = e.what();
+        }
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) {
+        std::cerr << "Usage: " << argv[0] << " <socket path> <query file> [connections] [seconds] [depth]\n";
+        return 1;
+    }
+    std::string socketPath = argv[1];
+    size_t connections = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+    double seconds = argc > 4 ? std::strtod(argv[4], nullptr) : 5.0;
+    size_t depth = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 8;
+
+    std::vector<std::string> queries;
+    {
+        std::ifstream file(argv[2]);
+        std::string line;
+        while (std::getline(file, line)) {
+            size_t first = line.find_first_not_of(" \t\r");
+            if (first == std::string::npos || line[first] == '#') continue;
+            queries.push_back(line.substr(first));
+        }
+    }
+    if (queries.empty() || connections == 0 || depth == 0) {
+        std::cerr << "Need at least one query, one connection and a depth of one\n";
+        return 1;
+    }
+
+    std::vector<ConnectionResult> results(connections);
+    std::vector<std::thread> clients;
+    auto start = Clock::now();
+    auto deadline = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    for (size_t c = 0; c < connections; ++c) {
+        clients.emplace_back(drive, socketPath, std::cref(queries), c * 7919, depth, deadline, std::ref(results[c]));
+    }
+    for (std::thread& client : clients) {
+        client.join();
+    }
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    std::vector<double> latencies;
+    size_t errors = 0;
+    for (const ConnectionResult& result : results) {
+        if (!result.failure.empty()) {
+            std::cerr << "Connection failed: " << result.failure << "\n";
+            return 1;
+        }
+        latencies.insert(latencies.end(), result.latencies.begin(), result.latencies.end());
+        errors += result.errors;
+    }
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << std::fixed << std::setprecision(1) << connections << " connections x " << depth << " in flight, "
+              << queries.size() << " distinct queries, " << elapsed << " s\n"
+              << latencies.size() << " requests (" << errors << " errors), "
+              << static_cast<double>(latencies.size()) / elapsed << " requests/s\n"
+              << "latency us: p50 " << percentile(latencies, 0.5) << ", p99 " << percentile(latencies, 0.99)
+              << ", p99.9 " << percentile(latencies, 0.999) << ", max " << latencies.back() << "\n";
+    return 0;
+}
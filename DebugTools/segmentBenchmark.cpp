@@ -0,0 +1,128 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Benchmark: per-batch ingest latency of a SegmentedIndex against rebuilding one
+// monolithic index (Indexer::merge) for every batch, plus merge write amplification
+//
+// Usage: COMP5421_SegmentBenchmark <text file> [lines per batch]
+//
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "SegmentedIndex/SegmentedIndex.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    double percentile(std::vector<double> values, double p) {
+        std::sort(values.begin(), values.end());
+        return values[static_cast<size_t>(p * static_cast<double>(values.size() - 1))];
+    }
+
+    void report(const char* name, const std::vector<double>& latencies) {
+        size_t quarter = std::max<size_t>(1, latencies.size() / 4);
+        double first = 0;
+        double last = 0;
+        for (size_t i = 0; i < quarter; ++i) {
+            first += latencies[i];
+            last += latencies[latencies.size() - 1 - i];
+        }
+        std::cout << std::setw(12) << name << std::setw(10) << percentile(latencies, 0.5) << std::setw(10)
+                  << percentile(latencies, 0.99) << std::setw(14) << first / static_cast<double>(quarter)
+                  << last / static_cast<double>(quarter) << "\n";
+    }
+
+    std::string dump(const Indexer& index) {
+        std::ostringstream out;
+        index.print(out);
+        return out.str();
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <text file> [lines per batch]\n";
+        return 1;
+    }
+    size_t batchLines = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+
+    std::vector<std::vector<std::string>> batches(1);
+    {
+        std::ifstream file(argv[1]);
+        std::string line;
+        while (std::getline(file, line)) {
+            if (batches.back().size() == batchLines) batches.emplace_back();
+            batches.back().push_back(line);
+        }
+    }
+    std::cout << batches.size() << " batches of up to " << batchLines << " lines\n\n";
+
+    // Segments: each batch is one new segment, merged in the background
+    SegmentedIndex segmented;
+    std::vector<double> segmentLatency;
+    for (const std::vector<std::string>& batch : batches) {
+        auto start = Clock::now();
+        segmented.ingest(batch);
+        segmentLatency.push_back(millisecondsSince(start));
+    }
+    auto start = Clock::now();
+    segmented.waitForMerges();
+    double drainTime = millisecondsSince(start);
+
+    // Monolithic: every batch is merged into the single index, rewriting all of it
+    Indexer monolithic;
+    std::vector<double> rebuildLatency;
+    for (const std::vector<std::string>& batch : batches) {
+        start = Clock::now();
+        Indexer part;
+        for (const std::string& line : batch) {
+            part.processLine(line);
+        }
+        monolithic.merge(part, static_cast<Indexer::line_type>(monolithic.getLineCount()));
+        rebuildLatency.push_back(millisecondsSince(start));
+    }
+
+    std::cout << std::left << std::fixed << std::setprecision(2) << std::setw(12) << "ingest ms" << std::setw(10)
+              << "p50" << std::setw(10) << "p99" << std::setw(14) << "first 25%" << "last 25%\n";
+    report("segments", segmentLatency);
+    report("monolithic", rebuildLatency);
+
+    SegmentedIndex::Stats stats = segmented.getStats();
+    std::cout << "\nsegments: " << stats.segments << " live after " << stats.merges << " merges (drained in "
+              << drainTime << " ms)\n"
+              << "write amplification: " << std::setprecision(2)
+              << static_cast<double>(stats.linesIngested + stats.linesMerged) / static_cast<double>(stats.linesIngested)
+              << "x (lines written per line ingested)\n";
+
+    if (dump(segmented.snapshot()) != dump(monolithic)) {
+        std::cout << "MISMATCH: merged segments differ from the monolithic index\n";
+        return 1;
+    }
+    for (const IndexedToken& entry : monolithic.range("", "")) {
+        if (segmented.occurrences(entry.getToken()) != entry.getLineNumbers()) {
+            std::cout << "MISMATCH: fan-out lookup of '" << entry.getToken() << "'\n";
+            return 1;
+        }
+        // Open-ended range: every posting up to the largest line number
+        std::span<const Indexer::line_type> all =
+            monolithic.occurrences(entry.getToken(), 0, std::numeric_limits<Indexer::line_type>::max());
+        if (std::vector<Indexer::line_type>(all.begin(), all.end()) != entry.getLineNumbers()) {
+            std::cout << "MISMATCH: open-ended range lookup of '" << entry.getToken() << "'\n";
+            return 1;
+        }
+    }
+    return 0;
+}
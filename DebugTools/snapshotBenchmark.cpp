@@ -0,0 +1,190 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Benchmark: query latency while the index is rebuilt, with published snapshots
+// (VersionedIndex) against a reader/writer lock held for the rebuild, and against
+// clearing first and locking line by line (which exposes half-built indexes)
+//
+// Usage: COMP5421_SnapshotBenchmark <text file> [reader threads] [rebuilds]
+//
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "VersionedIndex/VersionedIndex.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    struct ReaderResult {
+        std::vector<double> latencies;  // Microseconds per query
+        size_t partial = 0;             // Queries that saw fewer tokens than the full index
+    };
+
+    double percentile(std::vector<double>& values, double p) {
+        std::sort(values.begin(), values.end());
+        return values[static_cast<size_t>(p * static_cast<double>(values.size() - 1))];
+    }
+
+    // Readers look up words of the text until stopped; query(word) returns the token count it saw
+    template <typename Query>
+    void runReaders(size_t readers, const std::vector<std::string>& words, Indexer::count_type fullCount,
+                    const std::atomic<bool>& stop, std::vector<ReaderResult>& results, Query query) {
+        std::vector<std::thread> threads;
+        results.assign(readers, ReaderResult());
+        for (size_t r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r] {
+                ReaderResult& result = results[r];
+                // At least one query each, even if the rebuilds finish first
+                for (size_t i = r; i == r || !stop.load(std::memory_order_relaxed); i += readers) {
+                    auto start = Clock::now();
+                    Indexer::count_type seen = query(words[i % words.size()]);
+                    result.latencies.push_back(
+                        std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                    if (seen != fullCount) ++result.partial;
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    void report(const char* name, const std::vector<ReaderResult>& results, double rebuildMs) {
+        std::vector<double> all;
+        size_t partial = 0;
+        for (const ReaderResult& result : results) {
+            all.insert(all.end(), result.latencies.begin(), result.latencies.end());
+            partial += result.partial;
+        }
+        double worst = *std::max_element(all.begin(), all.end());
+        double p50 = percentile(all, 0.5);
+        double p99 = percentile(all, 0.99);
+        std::cout << std::setw(16) << name << std::setw(10) << all.size() << std::setw(10) << p50 << std::setw(10)
+                  << p99 << std::setw(12) << worst << std::setw(10) << partial << rebuildMs << "\n";
+    }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <text file> [reader threads] [rebuilds]\n";
+        return 1;
+    }
+    size_t readers = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 4;
+    size_t rebuilds = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 5;
+
+    std::vector<std::string> lines;
+    {
+        std::ifstream file(argv[1]);
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+    }
+    auto build = [&lines](Indexer& index) {
+        for (const std::string& line : lines) {
+            index.processLine(line);
+        }
+    };
+    Indexer full;
+    build(full);
+    Indexer::count_type fullCount = full.getTokenCount();
+    std::vector<std::string> words;
+    for (const IndexedToken& entry : full.range("", "")) {
+        words.push_back(entry.getToken());
+        if (words.size() == 1000) break;
+    }
+    std::cout << lines.size() << " lines, " << readers << " readers, " << rebuilds << " rebuilds\n\n"
+              << std::left << std::fixed << std::setprecision(1) << std::setw(16) << "" << std::setw(10) << "queries"
+              << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(12) << "max us" << std::setw(10)
+              << "partial" << "rebuild ms\n";
+
+    std::vector<ReaderResult> results;
+    std::atomic<bool> stop{false};
+    double rebuildMs = 0;
+    auto timeRebuilds = [&](auto rebuildOnce) {
+        auto start = Clock::now();
+        for (size_t i = 0; i < rebuilds; ++i) {
+            rebuildOnce();
+        }
+        rebuildMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count() /
+                    static_cast<double>(rebuilds);
+        stop = true;
+    };
+
+    // Snapshots: the rebuild happens aside and readers never wait
+    {
+        VersionedIndex versions(full);
+        stop = false;
+        std::thread writer([&] { timeRebuilds([&] { versions.rebuild(build); }); });
+        runReaders(readers, words, fullCount, stop, results, [&](const std::string& word) {
+            VersionedIndex::snapshot_type snapshot = versions.acquire();
+            snapshot->findToken(word);
+            return snapshot->getTokenCount();
+        });
+        writer.join();
+        report("snapshots", results, rebuildMs);
+        VersionedIndex::Stats stats = versions.getStats();
+        if (stats.generation != rebuilds || stats.live != 1) {
+            std::cout << "UNEXPECTED: " << stats.generation << " versions published, " << stats.live << " live\n";
+            return 1;
+        }
+    }
+
+    // Reader/writer lock held for the whole rebuild: consistent, but readers stall
+    {
+        Indexer index(full);
+        std::shared_mutex mutex;
+        stop = false;
+        std::thread writer([&] {
+            timeRebuilds([&] {
+                std::unique_lock<std::shared_mutex> lock(mutex);
+                index.clear();
+                build(index);
+            });
+        });
+        runReaders(readers, words, fullCount, stop, results, [&](const std::string& word) {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            index.findToken(word);
+            return index.getTokenCount();
+        });
+        writer.join();
+        report("rebuild locked", results, rebuildMs);
+    }
+
+    // Clear, then lock per line: what re-indexing in place looks like to readers
+    {
+        Indexer index(full);
+        std::shared_mutex mutex;
+        stop = false;
+        std::thread writer([&] {
+            timeRebuilds([&] {
+                {
+                    std::unique_lock<std::shared_mutex> lock(mutex);
+                    index.clear();
+                }
+                for (const std::string& line : lines) {
+                    std::unique_lock<std::shared_mutex> lock(mutex);
+                    index.processLine(line);
+                }
+            });
+        });
+        runReaders(readers, words, fullCount, stop, results, [&](const std::string& word) {
+            std::shared_lock<std::shared_mutex> lock(mutex);
+            index.findToken(word);
+            return index.getTokenCount();
+        });
+        writer.join();
+        report("clear in place", results, rebuildMs);
+    }
+    return 0;
+}
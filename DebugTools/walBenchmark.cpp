@@ -0,0 +1,113 @@
+//
+// Created by Alex Sutherland on 2026-10-19.
+// Benchmark: DurableIndexer ingest throughput for several log batching / fsync settings,
+// and recovery (checkpoint load + log replay) against the in-memory result
+//
+// Usage: COMP5421_WalBenchmark <text file> [work directory]
+//
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "DurableIndexer/DurableIndexer.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    double millisecondsSince(Clock::time_point start) {
+        return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+    }
+
+    std::string dump(const Indexer& index) {
+        std::ostringstream out;
+        index.print(out);
+        return out.str();
+    }
+
+    struct Setting {
+        const char* name;
+        size_t batchLines;
+        size_t syncEvery;
+    };
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <text file> [work directory]\n";
+        return 1;
+    }
+    std::filesystem::path work = argc > 2 ? argv[2] : std::filesystem::temp_directory_path() / "walBenchmark";
+
+    std::vector<std::string> lines;
+    {
+        std::ifstream file(argv[1]);
+        std::string line;
+        while (std::getline(file, line)) {
+            lines.push_back(line);
+        }
+    }
+    std::cout << lines.size() << " lines\n\n";
+
+    const Setting settings[] = {{"every line, synced", 1, 1},
+                                {"256-line batches, each synced", 256, 1},
+                                {"256-line batches, sync every 16", 256, 16},
+                                {"256-line batches, no fsync", 256, 0}};
+    std::cout << std::left << std::setw(34) << "setting" << std::setw(12) << "ms" << std::setw(14) << "lines/s"
+              << std::setw(10) << "records" << "syncs\n";
+    for (const Setting& setting : settings) {
+        std::filesystem::remove_all(work);
+        DurabilityOptions options;
+        options.batchLines = setting.batchLines;
+        options.syncEvery = setting.syncEvery;
+        options.checkpointEvery = 0;
+        DurableIndexer index(work.string(), options);
+        auto start = Clock::now();
+        for (const std::string& line : lines) {
+            index.processLine(line);
+        }
+        index.commit();
+        double time = millisecondsSince(start);
+        DurableIndexer::Stats stats = index.getStats();
+        std::cout << std::setw(34) << setting.name << std::setw(12) << std::fixed << std::setprecision(1) << time
+                  << std::setw(14) << std::setprecision(0) << static_cast<double>(lines.size()) * 1000.0 / time
+                  << std::setw(10) << stats.logRecords << stats.logSyncs << "\n";
+    }
+
+    // Half the input behind a checkpoint, half only in the log; reopening must rebuild both
+    std::filesystem::remove_all(work);
+    std::string expected;
+    double checkpointTime = 0;
+    {
+        DurableIndexer index(work.string());
+        for (size_t i = 0; i < lines.size(); ++i) {
+            if (i == lines.size() / 2) {
+                auto start = Clock::now();
+                index.checkpoint();
+                checkpointTime = millisecondsSince(start);
+            }
+            index.processLine(lines[i]);
+        }
+        index.commit();
+        expected = dump(index.getIndex());
+    }
+    auto start = Clock::now();
+    DurableIndexer recovered(work.string());
+    double recoveryTime = millisecondsSince(start);
+    DurableIndexer::Stats stats = recovered.getStats();
+    std::cout << "\ncheckpoint: " << std::setprecision(1) << checkpointTime << " ms\n"
+              << "recovery:   " << recoveryTime << " ms (checkpoint " << stats.checkpointGeneration << ", "
+              << stats.replayedRecords << " log records, " << stats.replayedLines << " lines replayed)\n";
+    bool same = dump(recovered.getIndex()) == expected;
+    std::filesystem::remove_all(work);
+    if (!same) {
+        std::cout << "MISMATCH: the recovered index differs from the one built\n";
+        return 1;
+    }
+    return 0;
+}